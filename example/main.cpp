@@ -27,7 +27,7 @@
 #include "sample_installer_page.hpp"
 #include "sample_loading_page.hpp"
 
-namespace i18n = brls::i18n; // for loadTranslations() and getStr()
+namespace i18n = brls::i18n; // for loadTranslations(), getStr() and setLocale()
 using namespace i18n::literals; // for _i18n
 
 std::vector<std::string> NOTIFICATIONS = {
@@ -49,7 +49,7 @@ int main(int argc, char* argv[])
     i18n::loadTranslations();
     if (!brls::Application::init("main/name"_i18n))
     {
-        brls::Logger::error("Unable to init Borealis application");
+        BRLS_LOG_ERROR("Unable to init Borealis application");
         return EXIT_FAILURE;
     }
 
@@ -89,7 +89,15 @@ int main(int argc, char* argv[])
     brls::ListItem* themeItem = new brls::ListItem("main/tv/resolution"_i18n);
     themeItem->setValue("main/tv/automatic"_i18n);
 
-    brls::ListItem* i18nItem = new brls::ListItem(i18n::getStr("main/i18n/title", i18n::getCurrentLocale(), "main/i18n/lang"_i18n));
+    // Bound to a translation: relabeled when switching locale
+    brls::ListItem* i18nItem = new brls::ListItem("");
+    i18nItem->setLabel(i18n::Translation("main/i18n/title", i18n::getLocale(), i18n::Translation("main/i18n/lang")));
+    i18nItem->getClickEvent()->subscribe([](brls::View* view) {
+        i18n::setLocale(i18n::getLocale() == "fr" ? "en-US" : "fr");
+
+        brls::ListItem* item = (brls::ListItem*)view;
+        item->setLabel(i18n::Translation("main/i18n/title", i18n::getLocale(), i18n::Translation("main/i18n/lang")));
+    });
 
     brls::SelectListItem* jankItem = new brls::SelectListItem(
         "main/jank/jank"_i18n,
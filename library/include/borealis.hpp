@@ -39,12 +39,15 @@
 #include <borealis/header.hpp>
 #include <borealis/i18n.hpp>
 #include <borealis/image.hpp>
+#include <borealis/input_manager.hpp>
 #include <borealis/label.hpp>
 #include <borealis/layer_view.hpp>
 #include <borealis/list.hpp>
 #include <borealis/logger.hpp>
 #include <borealis/material_icon.hpp>
+#include <borealis/nine_slice.hpp>
 #include <borealis/notification_manager.hpp>
+#include <borealis/observable.hpp>
 #include <borealis/popup_frame.hpp>
 #include <borealis/progress_display.hpp>
 #include <borealis/progress_spinner.hpp>
@@ -18,8 +18,14 @@
 
 #pragma once
 
+#include <borealis/i18n.hpp>
+#include <cstdint>
 #include <functional>
+#include <initializer_list>
+#include <optional>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
@@ -30,6 +36,7 @@ namespace brls
 class View;
 
 typedef std::function<bool(void)> ActionListener;
+typedef bool (View::*ActionMember)(void);
 
 // ZL and ZR do not exist here because GLFW doesn't know them
 enum class Key
@@ -50,6 +57,13 @@ enum class Key
     DDOWN  = GLFW_GAMEPAD_BUTTON_DPAD_DOWN,
 };
 
+static_assert(GLFW_GAMEPAD_BUTTON_LAST < 32, "Keys must fit in a 32 bits mask");
+
+inline uint32_t getKeyMask(Key key)
+{
+    return 1u << (unsigned)key;
+}
+
 struct Action
 {
     Key key;
@@ -59,10 +73,80 @@ struct Action
     bool hidden;
     ActionListener actionListener;
 
+    std::optional<i18n::Translation> hintTranslation; // if set, used instead of hintText
+
+    ActionMember actionMember = nullptr; // if set, called on the view instead of actionListener
+
+    std::string getHintText() const
+    {
+        return this->hintTranslation ? this->hintTranslation->str() : this->hintText;
+    }
+
     bool operator==(const Key other)
     {
         return this->key == other;
     }
 };
 
+/**
+ * An immutable set of actions shared by all instances
+ * of a view class, see View::setActionTable
+ */
+class ActionTable
+{
+  public:
+    ActionTable(std::initializer_list<Action> actions)
+        : actions(actions)
+    {
+        for (const Action& action : this->actions)
+            this->keys |= getKeyMask(action.key);
+    }
+
+    const Action* find(Key key) const
+    {
+        if (!(this->keys & getKeyMask(key)))
+            return nullptr;
+
+        for (const Action& action : this->actions)
+        {
+            if (action.key == key)
+                return &action;
+        }
+
+        return nullptr;
+    }
+
+    const std::vector<Action>& getActions() const
+    {
+        return this->actions;
+    }
+
+    uint32_t getKeys() const
+    {
+        return this->keys;
+    }
+
+  private:
+    std::vector<Action> actions;
+    uint32_t keys = 0;
+};
+
+/**
+ * Makes an action calling the given member function on the view
+ * it's fired for, so that it can be shared in an ActionTable
+ */
+template <typename T>
+Action memberAction(i18n::Translation hintText, Key key, bool (T::*member)(void), bool hidden = false)
+{
+    static_assert(std::is_base_of<View, T>::value, "Action members must belong to a view");
+    return { key, "", true, hidden, nullptr, hintText, static_cast<ActionMember>(member) };
+}
+
+template <typename T>
+Action memberAction(std::string hintText, Key key, bool (T::*member)(void), bool hidden = false)
+{
+    static_assert(std::is_base_of<View, T>::value, "Action members must belong to a view");
+    return { key, hintText, true, hidden, nullptr, std::nullopt, static_cast<ActionMember>(member) };
+}
+
 } // namespace brls
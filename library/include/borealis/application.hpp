@@ -27,6 +27,7 @@
 #include <borealis/background.hpp>
 #include <borealis/frame_context.hpp>
 #include <borealis/hint.hpp>
+#include <borealis/input_manager.hpp>
 #include <borealis/label.hpp>
 #include <borealis/logger.hpp>
 #include <borealis/notification_manager.hpp>
@@ -37,6 +38,8 @@
 #include <map>
 #include <vector>
 
+struct NVGLUframebuffer;
+
 namespace brls
 {
 
@@ -47,6 +50,9 @@ class FramerateCounter : public Label
     retro_time_t lastSecond = 0;
     unsigned frames         = 0;
 
+    unsigned long stateSaves        = 0;
+    unsigned long stateSavesAvoided = 0;
+
   public:
     FramerateCounter();
 
@@ -70,6 +76,11 @@ class Application
       * the whole screen and layout() will be called
       *
       * The view will gain focus if applicable
+      *
+      * PLUS (exit) and MINUS (framerate display) are global actions,
+      * only fired if no view of the focus chain handles the key: unlike
+      * before, a PLUS or MINUS action registered on the pushed view
+      * itself is no longer replaced and takes priority over them
       */
     static void pushView(View* view, ViewAnimation animation = ViewAnimation::FADE);
 
@@ -98,9 +109,27 @@ class Application
 
     static FontStash* getFontStash();
 
+    /**
+     * Posts a notification, can be called from any thread
+     */
     static void notify(std::string text);
 
-    static void onGamepadButtonPressed(char button, bool repeating);
+    /**
+     * Handles a press of the given button, repeated the given
+     * number of steps at once (focus only moves once)
+     */
+    static void onGamepadButtonPressed(char button, bool repeating, unsigned steps = 1);
+
+    /**
+     * Sends a typed character to the focused view, see View::onCharInput
+     */
+    static void onCharInput(unsigned int codepoint);
+
+    /**
+     * Returns true if the focused view takes typed characters,
+     * see View::acceptsCharInput
+     */
+    static bool isCharInputFocused();
 
     /**
       * "Crashes" the app (displays a fullscreen CrashFrame)
@@ -122,6 +151,7 @@ class Application
 
     static NVGcontext* getNVGContext();
     static TaskManager* getTaskManager();
+    static InputManager* getInputManager();
     static NotificationManager* getNotificationManager();
 
     static void setCommonFooter(std::string footer);
@@ -144,6 +174,25 @@ class Application
 
     static View* getCurrentFocus();
 
+    /**
+     * Marks the cached action chain of the focused view as outdated,
+     * to be called whenever actions or parents of views change
+     */
+    static void invalidateActionChain();
+
+    /**
+     * Returns the actions available everywhere, handled
+     * after the ones of the views
+     */
+    static const ActionTable* getGlobalActions();
+
+    /**
+     * Marks the snapshot of the views below the top translucent
+     * view as outdated if the given view is part of it,
+     * see View::invalidateDrawing
+     */
+    static void invalidateSnapshot(View* view);
+
     static std::string getTitle();
 
     /**
@@ -162,6 +211,7 @@ class Application
 
     inline static TaskManager* taskManager;
     inline static NotificationManager* notificationManager;
+    inline static InputManager* inputManager;
 
     inline static FontStash fontStash;
 
@@ -175,9 +225,6 @@ class Application
     inline static LibraryViewsThemeVariantsWrapper* currentThemeVariantsWrapper;
     inline static ThemeVariant currentThemeVariant;
 
-    inline static GLFWgamepadstate oldGamepad;
-    inline static GLFWgamepadstate gamepad;
-
     inline static Style* currentStyle;
 
     inline static unsigned blockInputsTokens = 0; // any value > 0 means inputs are blocked
@@ -193,7 +240,31 @@ class Application
     inline static GenericEvent globalFocusChangeEvent;
     inline static VoidEvent globalHintsUpdateEvent;
 
-    static void navigate(FocusDirection direction);
+    // For each key, the views having an action for it, from the
+    // focused view up to its root - rebuilt lazily when outdated
+    inline static std::vector<View*> actionChains[GLFW_GAMEPAD_BUTTON_LAST + 1];
+    inline static uint32_t actionChainKeys = 0;
+    inline static bool actionChainDirty    = true;
+
+    // Bumped when the focus or the views stack changes, for
+    // handleAction() to know that its chain may be outdated
+    inline static unsigned focusGeneration = 0;
+
+    static void rebuildActionChain();
+
+    // Views below a translucent view on top of the stack are
+    // rendered once in there and drawn as an image afterwards
+    inline static NVGLUframebuffer* snapshot = nullptr;
+    inline static View* snapshotOverlay      = nullptr; // top view when the snapshot was taken
+    inline static Theme* snapshotTheme       = nullptr; // theme when the snapshot was taken
+    inline static bool snapshotDirty         = true;
+    inline static bool snapshotFailed        = false; // framebuffers are unsupported, don't retry
+
+    static bool updateSnapshot(std::vector<View*>* viewsToDraw, FrameContext* frameContext);
+    static void deleteSnapshot();
+
+    static View* findNextFocus(View* currentFocus, FocusDirection direction);
+    static void navigate(FocusDirection direction, unsigned steps = 1);
 
     static void onWindowSizeChanged();
 
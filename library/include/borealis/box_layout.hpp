@@ -21,6 +21,8 @@
 #pragma once
 
 #include <borealis/view.hpp>
+#include <functional>
+#include <string>
 #include <vector>
 
 namespace brls
@@ -48,6 +50,55 @@ class BoxLayoutChild
   public:
     View* view;
     bool fill; // should the child fill the remaining space?
+
+    std::string key; // see BoxLayout::reconcile
+    size_t revision = 0;
+};
+
+// Describes the children of a BoxLayout, identified by stable keys
+// (see BoxLayout::reconcile)
+class BoxLayoutBuilder
+{
+  public:
+    typedef std::function<View*()> CreateCallback;
+    typedef std::function<void(View*)> UpdateCallback;
+
+    /**
+     * Describes the next child, identified by the given key
+     *
+     * create is only called if the layout doesn't have a child with that
+     * key yet, update is called on the child when it's created and when
+     * its revision changes (typically a version or hash of its data)
+     */
+    template <typename T>
+    void add(std::string key, size_t revision, std::function<T*()> create, std::function<void(T*)> update = nullptr, bool fill = false)
+    {
+        UpdateCallback viewUpdate;
+
+        if (update)
+            viewUpdate = [update](View* view) { update(static_cast<T*>(view)); };
+
+        this->entries.push_back({ std::move(key), revision, std::move(create), std::move(viewUpdate), fill });
+    }
+
+    void reserve(size_t count)
+    {
+        this->entries.reserve(count);
+    }
+
+  private:
+    struct Entry
+    {
+        std::string key;
+        size_t revision;
+        CreateCallback create;
+        UpdateCallback update;
+        bool fill;
+    };
+
+    std::vector<Entry> entries;
+
+    friend class BoxLayout;
 };
 
 // A basic horizontal or vertical box layout :
@@ -143,6 +194,17 @@ class BoxLayout : public View
      */
     void clear(bool free = true);
 
+    /**
+     * Updates the children to match the given description:
+     * children are created, updated, moved and removed according
+     * to their key and revision, the other ones are left untouched
+     *
+     * Children keep their focus and state, and if the focused
+     * child is removed the focus goes to its nearest sibling
+     * Children added with addView have no key and are removed
+     */
+    void reconcile(const BoxLayoutBuilder& builder);
+
     /**
       * Returns true if this layout
       * doesn't contain any views
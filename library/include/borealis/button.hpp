@@ -71,6 +71,7 @@ class Button : public View
     void setState(ButtonState state);
 
     Button* setLabel(std::string label);
+    Button* setLabel(i18n::Translation label);
     Button* setImage(std::string path);
     Button* setImage(unsigned char* buffer, size_t bufferSize);
 
@@ -22,7 +22,12 @@
 #include <borealis/event.hpp>
 #include <borealis/list.hpp>
 #include <borealis/view.hpp>
+#include <memory>
 #include <string>
+#include <vector>
+
+#define SELECT_VIEW_MAX_ITEMS 6 // for max height
+#define SELECT_VIEW_ROWS (SELECT_VIEW_MAX_ITEMS + 4) // recycled list items, enough to scroll two rows at once
 
 namespace brls
 {
@@ -36,25 +41,62 @@ namespace brls
 // as soon as this function is called
 typedef Event<int> ValueSelectedEvent;
 
+// Values of a Dropdown, can be shared to avoid copies
+typedef std::shared_ptr<const std::vector<std::string>> DropdownValues;
+
 // Allows the user to select between multiple
 // values
 // Use Dropdown::open()
+//
+// Only the visible values have a list item, so that opening
+// is as fast with thousands of values as it is with a few
+// Typing on a keyboard jumps to the first value starting with
+// the typed text, L and R jump to the previous and next letter
+//
+// Closed dropdowns are kept in a pool and reused by the next open()
 class Dropdown : public View
 {
   private:
-    Dropdown(std::string title, std::vector<std::string> values, ValueSelectedEvent::Callback cb, size_t selected = 0);
+    Dropdown();
+
+    inline static std::vector<Dropdown*> pool;
 
     std::string title;
 
-    int valuesCount;
+    DropdownValues values;
+    size_t valuesCount = 0;
+    size_t selected    = 0; // valuesCount if none
 
     ValueSelectedEvent valueEvent;
+    ValueSelectedEvent::Subscription valueSubscription = 0;
+
+    ListItem* rows[SELECT_VIEW_ROWS]; // value i is shown by row i % SELECT_VIEW_ROWS
+    size_t rowValues[SELECT_VIEW_ROWS]; // valuesCount if unbound
+
+    size_t cursor = 0; // focused value
+    float scrollY = 0.0f; // in pixels, from the top of the first value
+
+    int listX, listY;
+    unsigned listWidth, listHeight;
 
-    List* list;
     Hint* hint;
 
     float topOffset; // for slide in animation
 
+    std::string typeAheadText;
+    retro_time_t typeAheadTime = 0;
+
+    void bind(std::string title, DropdownValues values, ValueSelectedEvent::Callback cb, size_t selected);
+
+    ListItem* bindRow(size_t value);
+    unsigned getRowPitch(Style* style);
+    float getScrollTarget(size_t value);
+    void scrollTo(float target, bool animated);
+    void jumpTo(size_t value);
+
+    bool jumpToPreviousLetter();
+    bool jumpToNextLetter();
+
   protected:
     unsigned getShowAnimationDuration(ViewAnimation animation) override;
 
@@ -64,12 +106,22 @@ class Dropdown : public View
     void draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx) override;
     void layout(NVGcontext* vg, Style* style, FontStash* stash) override;
     View* getDefaultFocus() override;
+    View* getNextFocus(FocusDirection direction, View* currentView) override;
+    bool onCharInput(unsigned int codepoint) override;
+    bool acceptsCharInput() override;
     virtual bool onCancel();
     void show(std::function<void(void)> cb, bool animate = true, ViewAnimation animation = ViewAnimation::FADE) override;
     void willAppear(bool resetState = false) override;
     void willDisappear(bool resetState = false) override;
+    bool recycle() override;
 
     static void open(std::string title, std::vector<std::string> values, ValueSelectedEvent::Callback cb, int selected = -1);
+    static void open(std::string title, DropdownValues values, ValueSelectedEvent::Callback cb, int selected = -1);
+
+    /**
+     * Deletes the pooled dropdowns
+     */
+    static void clearPool();
 
     bool isTranslucent() override
     {
@@ -18,9 +18,10 @@
 
 #pragma once
 
-#include <algorithm>
+#include <borealis/small_vector.hpp>
+#include <cstdint>
 #include <functional>
-#include <list>
+#include <vector>
 
 namespace brls
 {
@@ -34,42 +35,130 @@ namespace brls
 // 4. call fire when you want to fire the events
 //    it wil return true if at least one subscriber exists
 //    for that event
+//
+// Subscribing and unsubscribing from a callback is allowed:
+// new subscribers are called starting from the next fire, and
+// removed ones are not called anymore
 template <typename... Ts>
 class Event
 {
   public:
     typedef std::function<void(Ts...)> Callback;
-    typedef std::list<Callback> CallbacksList;
-    typedef typename CallbacksList::iterator Subscription;
+    typedef uint64_t Subscription;
 
     Subscription subscribe(Callback cb);
     void unsubscribe(Subscription subscription);
     bool fire(Ts... args);
 
   private:
-    CallbacksList callbacks;
+    struct Entry
+    {
+        Subscription subscription;
+        Callback callback;
+        bool removed;
+    };
+
+    // Sorted by subscription, never reallocated while firing
+    SmallVector<Entry, 1> entries;
+
+    // Subscribed while firing, merged once done
+    std::vector<Entry> pendingEntries;
+
+    Subscription nextSubscription = 1;
+
+    unsigned firing  = 0; // nested fire() calls
+    bool hasRemovals = false;
 };
 
 template <typename... Ts>
 typename Event<Ts...>::Subscription Event<Ts...>::subscribe(Event<Ts...>::Callback cb)
 {
-    this->callbacks.push_back(cb);
-    return --this->callbacks.end();
+    Subscription subscription = this->nextSubscription++;
+
+    if (this->firing > 0)
+        this->pendingEntries.push_back({ subscription, std::move(cb), false });
+    else
+        this->entries.push_back({ subscription, std::move(cb), false });
+
+    return subscription;
 }
 
 template <typename... Ts>
 void Event<Ts...>::unsubscribe(Event<Ts...>::Subscription subscription)
 {
-    this->callbacks.erase(subscription);
+    size_t low = 0, high = this->entries.size();
+
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+
+        if (this->entries[middle].subscription < subscription)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if (low < this->entries.size() && this->entries[low].subscription == subscription)
+    {
+        // The callback may be running, only remove it once done
+        if (this->firing > 0)
+        {
+            this->entries[low].removed = true;
+            this->hasRemovals          = true;
+        }
+        else
+        {
+            this->entries.erase(low);
+        }
+
+        return;
+    }
+
+    for (auto it = this->pendingEntries.begin(); it != this->pendingEntries.end(); it++)
+    {
+        if (it->subscription == subscription)
+        {
+            this->pendingEntries.erase(it);
+            return;
+        }
+    }
 }
 
 template <typename... Ts>
 bool Event<Ts...>::fire(Ts... args)
 {
-    for (Callback cb : this->callbacks)
-        cb(args...);
+    bool subscribed = false;
+
+    this->firing++;
+
+    // Entries cannot move while firing
+    size_t count = this->entries.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (this->entries[i].removed)
+            continue;
+
+        subscribed = true;
+        this->entries[i].callback(args...);
+    }
+
+    this->firing--;
+
+    if (this->firing == 0)
+    {
+        if (this->hasRemovals)
+        {
+            this->entries.removeIf([](const Entry& entry) { return entry.removed; });
+            this->hasRemovals = false;
+        }
+
+        for (Entry& entry : this->pendingEntries)
+            this->entries.push_back(std::move(entry));
+
+        this->pendingEntries.clear();
+    }
 
-    return !this->callbacks.empty();
+    return subscribed;
 }
 
 }; // namespace brls
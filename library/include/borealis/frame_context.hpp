@@ -44,6 +44,9 @@ class FrameContext
     float pixelRatio     = 0.0;
     FontStash* fontStash = nullptr;
     Theme* theme         = nullptr;
+
+    unsigned stateSaves        = 0; // nvgSave() done by View::frame()
+    unsigned stateSavesAvoided = 0; // views drawn without nvgSave()
 };
 
 } // namespace brls
@@ -26,16 +26,32 @@
 namespace brls
 {
 
+// A displayed hint, its label is reused as long as the key and text don't change
+struct HintLabel
+{
+    Key key;
+    std::string text;
+    Label* label;
+};
+
 // Displays button hints for the currently focused view
 // Depending on the view's available actions
 // there can only be one Hint visible at any time
+//
+// Hints are rebuilt at most once per frame
 class Hint : public BoxLayout
 {
   private:
     bool animate;
 
+    bool rebuildRequested = true;
+
+    std::vector<HintLabel> hintLabels; // displayed, in order
+    std::vector<HintLabel> unusedHintLabels; // recently displayed, most recent last
+
     GenericEvent::Subscription globalFocusEventSubscriptor;
     VoidEvent::Subscription globalHintsUpdateEventSubscriptor;
+    VoidEvent::Subscription localeChangeEventSubscriptor;
 
     static inline std::vector<Hint*> globalHintStack;
 
@@ -46,11 +62,14 @@ class Hint : public BoxLayout
     static std::string getKeyIcon(Key key);
 
     void rebuildHints();
+    Label* takeHintLabel(Key key, const std::string& text);
 
   public:
     Hint(bool animate = true);
     ~Hint();
 
+    void frame(FrameContext* ctx) override;
+
     void willAppear(bool resetState = false) override;
     void willDisappear(bool resetState = false) override;
 
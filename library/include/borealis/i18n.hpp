@@ -20,7 +20,12 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <borealis/event.hpp>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 
 namespace brls::i18n
 {
@@ -29,7 +34,52 @@ namespace brls::i18n
 
 namespace internal
 {
-    std::string getRawStr(std::string stringName);
+    /**
+     * 64 bits FNV-1a hash of a string name, used as key
+     * of the translations table
+     */
+    constexpr uint64_t hashStr(const char* str, size_t len)
+    {
+        uint64_t hash = 0xcbf29ce484222325;
+
+        for (size_t i = 0; i < len; i++)
+        {
+            hash ^= (uint8_t)str[i];
+            hash *= 0x100000001b3;
+        }
+
+        return hash;
+    }
+
+    /**
+     * Returns the raw translation for the given string (and its
+     * precomputed hash), or the string name itself if it doesn't exist
+     *
+     * Doesn't allocate nor throw: the returned view points to the
+     * translations table (valid until translations are reloaded)
+     * or to stringName in case of fallback
+     */
+    std::string_view getRawStr(uint64_t hash, std::string_view stringName);
+
+    inline std::string_view getRawStr(std::string_view stringName)
+    {
+        return getRawStr(hashStr(stringName.data(), stringName.size()), stringName);
+    }
+
+    /**
+     * Returns the translation for the given string (and its precomputed
+     * hash) after injecting format parameters, or the string name
+     * itself if it doesn't exist or if its format is invalid
+     *
+     * The translation format is parsed and validated when loaded
+     */
+    std::string formatStr(uint64_t hash, std::string_view stringName, fmt::format_args args);
+
+    /**
+     * Called by Application once the first frame
+     * has been displayed
+     */
+    void onFirstFrame();
 } // namespace internal
 
 /**
@@ -37,26 +87,27 @@ namespace internal
  * after injecting format parameters (if any)
  */
 template <typename... Args>
-std::string getStr(std::string stringName, Args&&... args)
+std::string getStr(std::string_view stringName, Args&&... args)
 {
-    std::string rawStr = brls::i18n::internal::getRawStr(stringName);
-
-    try
-    {
-        return fmt::format(rawStr, args...);
-    }
-    catch (const std::exception& e)
-    {
-        Logger::error("Invalid format \"{}\" from string \"{}\": {}", rawStr, stringName, e.what());
-        return stringName;
-    }
+    return brls::i18n::internal::formatStr(internal::hashStr(stringName.data(), stringName.size()), stringName, fmt::make_format_args(args...));
 }
 
 /**
- * Loads all translations of the current system locale + default locale
+ * Finds all translations of the current system locale + default locale
  * Must be called before trying to get a translation!
+ *
+ * Each namespace (JSON file or catalog) is loaded the first
+ * time one of its strings is requested. If backgroundPreload is
+ * true, the namespaces that haven't been requested yet are
+ * preloaded in the background after the first frame
+ */
+void loadTranslations(bool backgroundPreload = true);
+
+/**
+ * Starts preloading all namespaces that are not
+ * loaded yet in the background
  */
-void loadTranslations();
+void preloadTranslations();
 
 /**
  * Returns the current system locale
@@ -64,14 +115,202 @@ void loadTranslations();
  */
 std::string getCurrentLocale();
 
+/**
+ * Switches the app to the given locale (or back to the
+ * system locale if empty) without restarting: translations
+ * are reloaded and every view bound to a Translation is
+ * relabeled
+ *
+ * Strings that were already resolved (with getStr() or _i18n)
+ * are NOT updated, use a Translation for those that need to be
+ */
+void setLocale(std::string locale);
+
+/**
+ * Returns the locale that's currently used in the app
+ */
+std::string getLocale();
+
+/**
+ * Fired by setLocale() after the translations are reloaded
+ */
+Event<>* getLocaleChangeEvent();
+
+/**
+ * A handle to a translated string: its name and format
+ * parameters (copied), resolved again every time it's needed
+ *
+ * Parameters can be Translations themselves
+ */
+class Translation
+{
+  public:
+    explicit Translation(std::string stringName)
+        : stringName(stringName)
+        , hash(internal::hashStr(stringName.data(), stringName.size()))
+    {
+    }
+
+    template <typename Arg, typename... Args>
+    Translation(std::string stringName, Arg arg, Args... args)
+        : Translation(stringName)
+    {
+        this->formatter = [stringName, arg, args...]() { return getStr(stringName, arg, args...); };
+    }
+
+    /**
+     * Returns the translation in the current locale
+     */
+    std::string str() const
+    {
+        if (this->formatter)
+            return this->formatter();
+
+        return std::string(internal::getRawStr(this->hash, this->stringName));
+    }
+
+    const std::string& getStringName() const
+    {
+        return this->stringName;
+    }
+
+  private:
+    std::string stringName;
+    uint64_t hash;
+
+    std::function<std::string()> formatter; // empty if there are no parameters
+};
+
+/**
+ * Keeps the text of a view up to date with a Translation:
+ * the callback is called immediately, then every time the locale changes
+ *
+ * Only bound views are relabeled on locale change, and the
+ * callback is responsible for invalidating what needs to be
+ */
+class TranslationBinding
+{
+  public:
+    typedef std::function<void(std::string)> Callback;
+
+    TranslationBinding() = default;
+    ~TranslationBinding();
+
+    TranslationBinding(const TranslationBinding&) = delete;
+    TranslationBinding& operator=(const TranslationBinding&) = delete;
+
+    void bind(Translation translation, Callback callback);
+    void unbind();
+
+    bool isBound();
+
+  private:
+    bool bound = false;
+    Event<>::Subscription subscription;
+};
+
+/**
+ * A translation returned by _i18n: a view into the translations
+ * table, only copied into a std::string where one is needed
+ *
+ * Valid until translations are reloaded (see setLocale()), keep
+ * a Translation or a std::string around for longer lived strings
+ */
+class TranslatedStr
+{
+  public:
+    constexpr explicit TranslatedStr(std::string_view str)
+        : str(str)
+    {
+    }
+
+    constexpr operator std::string_view() const
+    {
+        return this->str;
+    }
+
+    operator std::string() const
+    {
+        return std::string(this->str);
+    }
+
+  private:
+    std::string_view str;
+};
+
 inline namespace literals
 {
+#if defined(__GNUC__) && !defined(_MSC_VER)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#if defined(__clang__)
+#pragma clang diagnostic ignored "-Wgnu-string-literal-operator-template"
+#endif
     /**
      * Returns the translation for the given string, without
      * injecting any parameters
      * Shortcut to i18n::getStr(stringName)
+     *
+     * The string name is hashed at compile time using the GNU
+     * string literal operator template extension (GCC and clang)
      */
-    std::string operator"" _i18n(const char* str, size_t len);
+    template <typename CharT, CharT... Chars>
+    TranslatedStr operator"" _i18n()
+    {
+        static constexpr char stringName[] = { Chars..., '\0' };
+        static constexpr uint64_t hash     = internal::hashStr(stringName, sizeof...(Chars));
+
+        return TranslatedStr(internal::getRawStr(hash, std::string_view(stringName, sizeof...(Chars))));
+    }
+#pragma GCC diagnostic pop
+#else
+    /**
+     * Returns the translation for the given string, without
+     * injecting any parameters
+     * Shortcut to i18n::getStr(stringName)
+     *
+     * Other compilers don't have string literal operator templates:
+     * the string name is hashed at runtime (or folded by the optimizer)
+     */
+    inline TranslatedStr operator"" _i18n(const char* str, size_t len)
+    {
+        return TranslatedStr(internal::getRawStr(internal::hashStr(str, len), std::string_view(str, len)));
+    }
+#endif
 } // namespace literals
 
 } // namespace brls::i18n
+
+// Allows using Translations as format parameters (without format spec)
+template <>
+struct fmt::formatter<brls::i18n::Translation>
+{
+    constexpr auto parse(fmt::format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const brls::i18n::Translation& translation, FormatContext& ctx)
+    {
+        std::string str = translation.str();
+        return std::copy(str.begin(), str.end(), ctx.out());
+    }
+};
+
+// Allows using _i18n strings as format parameters (without format spec)
+template <>
+struct fmt::formatter<brls::i18n::TranslatedStr>
+{
+    constexpr auto parse(fmt::format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    template <typename FormatContext>
+    auto format(const brls::i18n::TranslatedStr& translatedStr, FormatContext& ctx)
+    {
+        std::string_view str = translatedStr;
+        return std::copy(str.begin(), str.end(), ctx.out());
+    }
+};
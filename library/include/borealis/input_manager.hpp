@@ -0,0 +1,180 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libretro-common/features/features_cpu.h>
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace brls
+{
+
+// A timestamped button state change, or a typed character
+struct InputEvent
+{
+    retro_time_t time; // in microseconds, see cpu_features_get_time_usec
+    int button; // GLFW_GAMEPAD_BUTTON_*, -1 for a typed character
+    bool pressed;
+    unsigned int codepoint = 0; // typed character, if button is -1
+};
+
+// Collects button state changes from the keyboard and the gamepad
+// in a timestamped queue, then dispatches them as presses and repeats
+// timed on the wall clock, independently of the frame rate
+class InputManager
+{
+  public:
+    ~InputManager();
+
+    // Called from the GLFW key callback
+    void onKeyboardKey(int key, int action, retro_time_t time);
+
+    // Called from the GLFW char callback, queues the
+    // character for Application::onCharInput
+    void onCharInput(unsigned int codepoint, retro_time_t time);
+
+    /**
+     * Reads the gamepad state and queues its changes
+     * Can be called more than once per frame to catch short presses
+     */
+    void pollGamepad(retro_time_t time);
+
+    /**
+     * Dispatches queued events then due repeats
+     * to Application::onGamepadButtonPressed
+     */
+    void update(retro_time_t now);
+
+    /**
+     * Sets the left stick deadzone, between 0 and 1
+     * The stick navigates like the DPAD outside of it
+     */
+    void setStickDeadzone(float deadzone);
+
+    /**
+     * Records all inputs to the given file, in the replay
+     * format (see startReplay)
+     * Returns false if the file cannot be opened
+     */
+    bool startRecording(std::string path);
+    void stopRecording();
+
+    /**
+     * Replays the inputs of the given file instead of the real ones
+     *
+     * Each line is "<time in ms> press <button>", "<time in ms> release <button>",
+     * "<time in ms> stick <x> <y>", "<time in ms> char <codepoint>" or "<time in ms> quit",
+     * with buttons named like brls::Key (A, DDOWN, PLUS...) and typed characters
+     * as decimal Unicode codepoints - empty lines and lines starting with # are ignored
+     *
+     * With the virtual clock, replay time advances by exactly one 60Hz frame
+     * per update so that runs are identical whatever the frame rate
+     * Frame times are logged at the end of the replay
+     *
+     * Returns false if the file cannot be read
+     */
+    bool startReplay(std::string path, bool virtualClock = true);
+    void stopReplay();
+
+    bool isReplaying();
+
+  private:
+    // Left stick navigation: steps are accumulated at a rate depending on
+    // the deflection and the time spent deflected, then sent all at once
+    struct StickState
+    {
+        int button              = -1; // DPAD button for the current direction, -1 if centered
+        float deflection        = 0.0f; // past the deadzone, between 0 and 1
+        int pressButton         = -1; // DPAD button of the last deflection
+        bool pressPending       = false; // set when deflected, until the press is dispatched
+        retro_time_t pressTime  = 0;
+        retro_time_t lastUpdate = 0;
+        float steps             = 0.0f; // pending fractional steps
+    };
+
+    float stickDeadzone = 0.3f;
+    StickState stick;
+
+    void pollStick(float x, float y, retro_time_t time);
+    void updateStick(retro_time_t now);
+
+    struct ButtonState
+    {
+        bool pressed            = false;
+        retro_time_t nextRepeat = 0;
+    };
+
+    std::vector<InputEvent> events; // in time order
+
+    uint32_t keyboardButtons = 0;
+    uint32_t gamepadButtons  = 0;
+    uint32_t replayButtons   = 0;
+
+    ButtonState buttons[GLFW_GAMEPAD_BUTTON_LAST + 1];
+
+    void setButtons(uint32_t oldButtons, uint32_t newButtons, uint32_t otherButtons, retro_time_t time);
+
+    // Recording
+    std::ofstream recordFile;
+    retro_time_t recordStart = 0;
+    float recordedStickX     = 0.0f;
+    float recordedStickY     = 0.0f;
+
+    void record(retro_time_t time, std::string command);
+
+    // Replay
+    enum class ReplayCommand
+    {
+        PRESS,
+        RELEASE,
+        STICK,
+        CHAR,
+        QUIT,
+    };
+
+    struct ReplayEntry
+    {
+        retro_time_t time; // since the start of the replay
+        ReplayCommand command;
+        int button;
+        float x, y;
+        unsigned int codepoint;
+    };
+
+    std::vector<ReplayEntry> replayEntries;
+    size_t replayPosition    = 0;
+    bool replaying           = false;
+    bool replayVirtualClock  = true;
+    retro_time_t replayStart = -1; // set by the first update
+    retro_time_t replayTime  = 0; // virtual clock
+
+    unsigned replayFrames         = 0;
+    retro_time_t replayRealTime   = 0; // of the last update
+    retro_time_t replayWorstFrame = 0;
+
+    retro_time_t updateReplay(retro_time_t now);
+};
+
+} // namespace brls
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <borealis/i18n.hpp>
+#include <borealis/observable.hpp>
 #include <borealis/view.hpp>
 
 namespace brls
@@ -63,8 +65,18 @@ class Label : public View
     int customFont;
     bool useCustomFont = false;
 
+    i18n::TranslationBinding textBinding;
+    ObservableBinding<std::string> textObservableBinding;
+
+    // Single line text width, measured once until the text or font changes
+    float textWidth   = 0.0f;
+    bool textMeasured = false;
+
+    void updateText(std::string text);
+
   public:
     Label(LabelStyle labelStyle, std::string text, bool multiline = false);
+    Label(LabelStyle labelStyle, i18n::Translation text, bool multiline = false);
 
     void draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx) override;
     void layout(NVGcontext* vg, Style* style, FontStash* stash) override;
@@ -72,6 +84,18 @@ class Label : public View
     void setVerticalAlign(NVGalign align);
     void setHorizontalAlign(NVGalign align);
     void setText(std::string text);
+
+    /**
+     * Sets the label text to the given translation,
+     * updated when the locale changes
+     */
+    void setText(i18n::Translation text);
+
+    /**
+     * Binds the label text to the given observable,
+     * updated once per frame at most when it changes
+     */
+    void setText(Observable<std::string>* text);
     void setStyle(LabelStyle style);
     void setFontSize(unsigned size);
 
@@ -24,6 +24,7 @@
 #include <borealis/label.hpp>
 #include <borealis/rectangle.hpp>
 #include <borealis/scroll_view.hpp>
+#include <memory>
 #include <string>
 
 namespace brls
@@ -58,7 +59,12 @@ class ListItem : public View
 
     bool indented = false;
 
+    i18n::TranslationBinding labelBinding;
+    i18n::TranslationBinding valueBinding;
+    ObservableBinding<std::string> valueObservableBinding;
+
     void resetValueAnimation();
+    void updateValue(std::string value, bool faint, bool animate);
 
   public:
     ListItem(std::string label, std::string description = "", std::string subLabel = "");
@@ -86,6 +92,7 @@ class ListItem : public View
     void setChecked(bool checked);
 
     void setLabel(std::string label);
+    void setLabel(i18n::Translation label);
     std::string getLabel();
 
     /**
@@ -95,6 +102,13 @@ class ListItem : public View
      * use a darker color (typically "OFF" labels)
      */
     void setValue(std::string value, bool faint = false, bool animate = true);
+    void setValue(i18n::Translation value, bool faint = false, bool animate = true);
+
+    /**
+     * Binds the value of this list item to the given observable,
+     * updated (and animated) once per frame at most when it changes
+     */
+    void setValue(Observable<std::string>* value, bool faint = false, bool animate = true);
     std::string getValue();
 
     GenericEvent* getClickEvent();
@@ -118,10 +132,14 @@ class ListItemGroupSpacing : public Rectangle
 // or -1 if the user cancelled
 typedef Event<int> ValueSelectedEvent;
 
+// Values of a SelectListItem, shared with its Dropdown
+typedef std::shared_ptr<const std::vector<std::string>> DropdownValues;
+
 class SelectListItem : public ListItem
 {
   public:
     SelectListItem(std::string label, std::vector<std::string> values, unsigned selectedValue = 0, std::string description = "");
+    SelectListItem(std::string label, DropdownValues values, unsigned selectedValue = 0, std::string description = "");
 
     void setSelectedValue(unsigned value);
     unsigned getSelectedValue();
@@ -129,7 +147,7 @@ class SelectListItem : public ListItem
     ValueSelectedEvent* getValueSelectedEvent();
 
   protected:
-    std::vector<std::string> values;
+    DropdownValues values;
     unsigned selectedValue = 0;
 
     ValueSelectedEvent valueEvent;
@@ -211,6 +229,7 @@ class List : public ScrollView
     void addView(View* view, bool fill = false);
     void removeView(int index, bool free = true);
     void clear(bool free = true);
+    void reconcile(const BoxLayoutBuilder& builder);
     size_t getViewsCount();
     View* getChild(size_t i);
     void setMargins(unsigned top, unsigned right, unsigned bottom, unsigned left);
@@ -19,9 +19,50 @@
 
 #pragma once
 
-#include <fmt/core.h>
+#include <fmt/format.h>
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Log levels above this one are compiled out of BRLS_LOG_* calls
+// 0 = errors, 1 = warnings, 2 = info, 3 = debug (everything)
+#ifndef BRLS_LOG_MAX_LEVEL
+#define BRLS_LOG_MAX_LEVEL 3
+#endif
+
+// Logs with a format string checked at compile time. Calls above
+// BRLS_LOG_MAX_LEVEL compile to nothing, and arguments are only
+// evaluated if the level is enabled at runtime
+//
+// In binary mode, the format string is registered once and
+// only the arguments are logged (see Logger::setBinaryLogFile())
+#define BRLS_LOG(level, format, ...)                                                                 \
+    do                                                                                               \
+    {                                                                                                \
+        if constexpr (brls::Logger::isCompiledIn(level))                                             \
+        {                                                                                            \
+            if (brls::Logger::isEnabled(level))                                                      \
+            {                                                                                        \
+                if (brls::Logger::isBinary())                                                        \
+                {                                                                                    \
+                    static const brls::LogFormat brlsLogFormat(level, format, __FILE__, __LINE__); \
+                    brls::Logger::logBinary(brlsLogFormat, ##__VA_ARGS__);                           \
+                }                                                                                    \
+                else                                                                                 \
+                {                                                                                    \
+                    brls::Logger::log(level, FMT_STRING(format), ##__VA_ARGS__);                     \
+                }                                                                                    \
+            }                                                                                        \
+        }                                                                                            \
+    } while (0)
+
+#define BRLS_LOG_ERROR(format, ...) BRLS_LOG(brls::LogLevel::ERROR, format, ##__VA_ARGS__)
+#define BRLS_LOG_WARNING(format, ...) BRLS_LOG(brls::LogLevel::WARNING, format, ##__VA_ARGS__)
+#define BRLS_LOG_INFO(format, ...) BRLS_LOG(brls::LogLevel::INFO, format, ##__VA_ARGS__)
+#define BRLS_LOG_DEBUG(format, ...) BRLS_LOG(brls::LogLevel::DEBUG, format, ##__VA_ARGS__)
 
 namespace brls
 {
@@ -34,60 +75,212 @@ enum class LogLevel
     DEBUG
 };
 
-class Logger
+// The format string of a BRLS_LOG_* call, registered
+// the first time it's logged in binary mode
+struct LogFormat
 {
-  public:
-    static void setLogLevel(LogLevel logLevel);
+    LogFormat(LogLevel level, const char* format, const char* file, int line);
 
-    template <typename... Args>
-    inline static void log(LogLevel logLevel, std::string prefix, std::string color, std::string format, Args&&... args)
+    uint32_t id;
+    LogLevel level;
+    const char* format;
+    const char* file;
+    int line;
+};
+
+namespace internal
+{
+    // Type of an argument in a binary log record, followed by its value
+    enum class LogArgType : uint8_t
     {
-        if (Logger::logLevel < logLevel)
-            return;
+        SIGNED = 0, // i64
+        UNSIGNED, // u64
+        FLOAT, // f64
+        BOOL, // u8
+        CHAR, // u8
+        STRING, // length (u32) + UTF-8 bytes
+        POINTER, // u64
+    };
+
+    inline void encodeLogValue(std::vector<uint8_t>* buffer, LogArgType type, const void* data, size_t size)
+    {
+        buffer->push_back((uint8_t)type);
+        buffer->insert(buffer->end(), (const uint8_t*)data, (const uint8_t*)data + size);
+    }
+
+    inline void encodeLogString(std::vector<uint8_t>* buffer, std::string_view str)
+    {
+        uint32_t length = str.length();
 
-        try
+        encodeLogValue(buffer, LogArgType::STRING, &length, sizeof(length));
+        buffer->insert(buffer->end(), str.begin(), str.end());
+    }
+
+    // Types that cannot be stored as is are formatted right away
+    template <typename T>
+    void encodeLogArg(std::vector<uint8_t>* buffer, const T& arg)
+    {
+        if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>)
+        {
+            uint8_t value = arg;
+            encodeLogValue(buffer, std::is_same_v<T, bool> ? LogArgType::BOOL : LogArgType::CHAR, &value, sizeof(value));
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            encodeLogArg(buffer, (std::underlying_type_t<T>)arg);
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            int64_t value = arg;
+            encodeLogValue(buffer, LogArgType::SIGNED, &value, sizeof(value));
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            uint64_t value = arg;
+            encodeLogValue(buffer, LogArgType::UNSIGNED, &value, sizeof(value));
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            double value = arg;
+            encodeLogValue(buffer, LogArgType::FLOAT, &value, sizeof(value));
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            encodeLogString(buffer, std::string_view(arg));
+        }
+        else if constexpr (std::is_pointer_v<T> && (std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, unsigned char> || std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, signed char>))
+        {
+            // Formatted as C strings by fmt, such as the GLubyte strings of glGetString()
+            encodeLogString(buffer, arg ? std::string_view((const char*)arg) : std::string_view("(null)"));
+        }
+        else if constexpr (std::is_pointer_v<T>)
         {
-            fmt::print("\033{}[{}]\033[0m ", color, prefix);
-            fmt::print(format, args...);
-            fmt::print("\n");
+            uint64_t value = (uintptr_t)arg;
+            encodeLogValue(buffer, LogArgType::POINTER, &value, sizeof(value));
         }
-        catch (const std::exception& e)
+        else
         {
-            // will be printed after the first fmt::print (so after the log tag)
-            printf("! Invalid log format string: \"%s\": %s\n", format.c_str(), e.what());
+            encodeLogString(buffer, fmt::format("{}", arg));
         }
+    }
+} // namespace internal
 
-#ifdef __MINGW32__
-        fflush(0);
-#endif
+// Asynchronous logger: messages are formatted by the calling thread
+// into a lock-free ring buffer, and written to stdout (and to the log file,
+// if any) by a background thread
+//
+// Messages are dropped (and counted) if the ring buffer is full, and
+// are truncated to LOG_MESSAGE_MAX_LENGTH characters
+class Logger
+{
+  public:
+    static void setLogLevel(LogLevel logLevel);
+
+    /**
+     * Also writes the logs to the given file, rotated when it
+     * exceeds maxSize bytes: path is renamed to path.1, path.1 to path.2...
+     * up to maxFiles old files
+     *
+     * Returns false if the file cannot be opened
+     */
+    static bool setLogFile(std::string path, size_t maxSize = 1024 * 1024, unsigned maxFiles = 3);
+
+    /**
+     * Switches BRLS_LOG_* calls to binary mode: instead of being formatted,
+     * their messages are written to the given file as a format string id
+     * and raw arguments, to be decoded offline with scripts/log-decoder.py
+     *
+     * Returns false if the file cannot be opened
+     */
+    static bool setBinaryLogFile(std::string path);
+
+    static bool isBinary()
+    {
+        return Logger::binary;
     }
 
-    template <typename... Args>
-    inline static void error(std::string format, Args&&... args)
+    /**
+     * Blocks until every message logged so far is written
+     * Called automatically on exit
+     *
+     * On crash (except on Switch and Windows), the text messages that
+     * are still pending are written without timestamp, unless the writer
+     * thread was interrupted while writing. Pending binary records are lost
+     */
+    static void flush();
+
+    /**
+     * Returns the number of messages dropped because
+     * the ring buffer was full
+     */
+    static size_t getDroppedCount();
+
+    /**
+     * Returns true if the given level is enabled at compile time
+     */
+    static constexpr bool isCompiledIn(LogLevel logLevel)
     {
-        Logger::log(LogLevel::ERROR, "ERROR", "[0;31m", format, args...);
+        return (int)logLevel <= BRLS_LOG_MAX_LEVEL;
     }
 
-    template <typename... Args>
-    inline static void warning(std::string format, Args&&... args)
+    /**
+     * Returns true if messages of the given level are logged
+     */
+    static bool isEnabled(LogLevel logLevel)
     {
-        Logger::log(LogLevel::WARNING, "WARNING", "[0;33m", format, args...);
+        return Logger::isCompiledIn(logLevel) && Logger::logLevel >= logLevel;
     }
 
-    template <typename... Args>
-    inline static void info(std::string format, Args&&... args)
+    template <typename S, typename... Args>
+    inline static void log(LogLevel logLevel, const S& format, Args&&... args)
     {
-        Logger::log(LogLevel::INFO, "INFO", "[0;34m", format, args...);
+        if (!Logger::isEnabled(logLevel))
+            return;
+
+        Logger::vlog(logLevel, fmt::to_string_view(format), fmt::detail::make_args_checked<Args...>(format, args...));
     }
 
     template <typename... Args>
-    inline static void debug(std::string format, Args&&... args)
+    inline static void logBinary(const LogFormat& format, const Args&... args)
+    {
+        thread_local std::vector<uint8_t> buffer;
+        buffer.clear();
+
+        (internal::encodeLogArg(&buffer, args), ...);
+
+        Logger::pushBinary(format, buffer.data(), buffer.size(), sizeof...(Args));
+    }
+
+    template <typename S, typename... Args>
+    inline static void error(const S& format, Args&&... args)
+    {
+        Logger::log(LogLevel::ERROR, format, args...);
+    }
+
+    template <typename S, typename... Args>
+    inline static void warning(const S& format, Args&&... args)
+    {
+        Logger::log(LogLevel::WARNING, format, args...);
+    }
+
+    template <typename S, typename... Args>
+    inline static void info(const S& format, Args&&... args)
     {
-        Logger::log(LogLevel::DEBUG, "DEBUG", "[0;32m", format, args...);
+        Logger::log(LogLevel::INFO, format, args...);
+    }
+
+    template <typename S, typename... Args>
+    inline static void debug(const S& format, Args&&... args)
+    {
+        Logger::log(LogLevel::DEBUG, format, args...);
     }
 
   private:
     inline static LogLevel logLevel = LogLevel::INFO;
+    inline static bool binary       = false;
+
+    static void vlog(LogLevel logLevel, fmt::string_view format, fmt::format_args args);
+    static void pushBinary(const LogFormat& format, const uint8_t* args, size_t argsSize, uint8_t argsCount);
 };
 
 } // namespace brls
@@ -0,0 +1,99 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <nanovg/nanovg.h>
+
+#include <array>
+#include <functional>
+#include <map>
+
+namespace brls
+{
+
+// A texture made of four corners, four edges and a center,
+// drawn at any size by only stretching the edges and the center
+class NineSlice
+{
+  public:
+    // Coverage of the texture at the given point, between 0 and 1
+    typedef std::function<float(float x, float y)> Coverage;
+
+    /**
+     * Creates a white texture of the given size using the coverage
+     * as alpha, with the given corners size
+     *
+     * Sizes are in logical pixels, the texture is rendered at the
+     * given scale to match the device pixels it will be drawn on
+     */
+    NineSlice(NVGcontext* vg, unsigned width, unsigned height, unsigned left, unsigned top, unsigned right, unsigned bottom, float scale, Coverage coverage);
+    ~NineSlice();
+
+    /**
+     * Draws the texture stretched to the given rect, tinted with the given color
+     * Slices are aligned on device pixels since they are not antialiased
+     *
+     * Returns false without drawing if the rect is too small for the corners
+     */
+    bool draw(NVGcontext* vg, float x, float y, float width, float height, NVGcolor tint, bool drawCenter = true);
+
+  private:
+    NVGcontext* vg;
+    int image;
+
+    unsigned width, height;
+    unsigned left, top, right, bottom;
+
+    float textureWidth, textureHeight; // in logical pixels, rounded up to whole device pixels
+};
+
+// Draws the decorations of views (shadows, highlight border)
+// using nine slice textures, rendered once for every set of metrics
+// instead of filling gradients through the stencil buffer every frame
+//
+// Colors are applied by tinting, so that themes share the same textures
+// Textures are rendered at the window scale, see clear()
+class Decorations
+{
+  public:
+    /**
+     * Draws the shadow of the given rounded rect, like
+     * a box gradient shifted down by shadowWidth with the
+     * rect as a hole
+     */
+    static void drawShadow(NVGcontext* vg, float x, float y, float width, float height, float cornerRadius, float shadowWidth, float shadowFeather, float shadowOffset, NVGcolor color);
+
+    /**
+     * Strokes the given rounded rect
+     */
+    static void drawBorder(NVGcontext* vg, float x, float y, float width, float height, float cornerRadius, float strokeWidth, NVGcolor color);
+
+    /**
+     * Deletes all textures, must be called before the nanovg context
+     * is deleted and when the window scale changes
+     */
+    static void clear();
+
+  private:
+    // Metrics and window scale
+    inline static std::map<std::array<float, 5>, NineSlice*> shadows;
+    inline static std::map<std::array<float, 3>, NineSlice*> borders;
+};
+
+} // namespace brls
@@ -21,8 +21,13 @@
 #include <borealis/animations.hpp>
 #include <borealis/label.hpp>
 #include <borealis/view.hpp>
+#include <deque>
+#include <mutex>
+#include <vector>
 
-#define BRLS_NOTIFICATIONS_MAX 8
+#define BRLS_NOTIFICATIONS_MAX 8 // visible at once
+#define BRLS_NOTIFICATIONS_QUEUE_MAX 32 // waiting to be shown, more are discarded
+#define BRLS_NOTIFICATIONS_RATE 4 // shown per second at most, after a burst of as many
 
 // TODO: check in HOS that the animation duration + notification timeout are correct
 
@@ -32,32 +37,69 @@ namespace brls
 class Notification : public View
 {
   public:
-    Notification(std::string text);
+    Notification();
     ~Notification();
 
     void draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx) override;
     void layout(NVGcontext* vg, Style* style, FontStash* stash) override;
 
+    /**
+     * Sets the text of the notification and how many
+     * times it has been posted
+     */
+    void setText(std::string text, unsigned count = 1);
+
+    const std::string& getText();
+    unsigned getCount();
+
     menu_timer_t timeoutTimer;
 
   private:
     Label* label;
+
+    std::string text;
+    unsigned count = 1;
 };
 
+// Shows notifications on top of everything else
+// Notifications can be posted from any thread: they are queued, coalesced
+// with identical ones and shown on the next frames, a few at a time
 class NotificationManager : public View
 {
   private:
-    Notification* notifications[BRLS_NOTIFICATIONS_MAX];
+    struct PendingNotification
+    {
+        std::string text;
+        unsigned count;
+    };
+
+    std::mutex pendingMutex;
+    std::deque<PendingNotification> pendingNotifications; // guarded by pendingMutex
+
+    std::vector<Notification*> notifications; // visible, from top to bottom
+    std::vector<Notification*> pool; // hidden, ready to be reused
+
+    float tokens            = BRLS_NOTIFICATIONS_RATE; // rate limiting
+    retro_time_t tokensTime = 0;
+
+    bool coalesceNotification(const PendingNotification& pending);
+    void showNotification(const PendingNotification& pending);
+    void startTimeout(Notification* notification);
+    void removeNotification(Notification* notification);
 
-    void layoutNotification(size_t i);
+    void layoutNotifications();
 
   public:
-    NotificationManager();
+    NotificationManager() = default;
     ~NotificationManager();
 
+    void frame(FrameContext* ctx) override;
     void draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx) override;
     void layout(NVGcontext* vg, Style* style, FontStash* stash) override;
 
+    /**
+     * Posts a notification, can be called from any thread
+     */
     void notify(std::string text);
 };
 
@@ -0,0 +1,188 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <libretro-common/features/features_cpu.h>
+
+#include <atomic>
+#include <borealis/event.hpp>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace brls
+{
+
+// Base class of all observables, see Observable
+class ObservableBase
+{
+  public:
+    ObservableBase() = default;
+    virtual ~ObservableBase();
+
+    ObservableBase(const ObservableBase&) = delete;
+    ObservableBase& operator=(const ObservableBase&) = delete;
+
+    /**
+     * Sets the minimum time between two updates of the bound
+     * views, in milliseconds (0 to update them every frame)
+     */
+    void setThrottle(unsigned throttle);
+
+    /**
+     * Updates the views bound to the changed observables,
+     * called by the application once per frame before drawing
+     */
+    static void flushAll();
+
+  protected:
+    /**
+     * Schedules an update of the bound views,
+     * can be called from any thread
+     */
+    void markDirty();
+
+    /**
+     * Fires the change event with the current value
+     */
+    virtual void flush() = 0;
+
+  private:
+    std::atomic<bool> pending { false }; // in the pending list
+    unsigned throttle      = 0;
+    retro_time_t lastFlush = 0;
+
+    inline static std::mutex pendingMutex;
+    inline static std::vector<ObservableBase*> pendingObservables; // guarded by pendingMutex
+
+    inline static std::vector<ObservableBase*> flushingObservables; // main thread only
+};
+
+// A value views can bind to (see ObservableBinding)
+//
+// Setting the value does not touch the views: the observable is marked dirty
+// and the bound callbacks are called once per frame at most, with the latest
+// value, no matter how many times it changed in between
+//
+// The value can be set from any thread, the callbacks are always
+// called on the main thread
+// Observables must be destroyed on the main thread and must outlive
+// their bindings
+template <typename T>
+class Observable : public ObservableBase
+{
+  public:
+    typedef Event<const T&> ChangeEvent;
+
+    explicit Observable(T value = T())
+        : value(std::move(value))
+    {
+    }
+
+    void set(T value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->value = std::move(value);
+        }
+
+        this->markDirty();
+    }
+
+    T get()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->value;
+    }
+
+    /**
+     * Fired on the main thread once per frame at most
+     * when the value changed
+     */
+    ChangeEvent* getChangeEvent()
+    {
+        return &this->changeEvent;
+    }
+
+  protected:
+    void flush() override
+    {
+        T value = this->get();
+        this->changeEvent.fire(value);
+    }
+
+  private:
+    std::mutex mutex; // for value
+    T value;
+
+    ChangeEvent changeEvent;
+};
+
+/**
+ * Keeps a view up to date with an Observable: the callback is
+ * called immediately, then every frame the value changed in
+ *
+ * The callback is responsible for invalidating what needs to be
+ */
+template <typename T>
+class ObservableBinding
+{
+  public:
+    typedef std::function<void(const T&)> Callback;
+
+    ObservableBinding() = default;
+
+    ~ObservableBinding()
+    {
+        this->unbind();
+    }
+
+    ObservableBinding(const ObservableBinding&) = delete;
+    ObservableBinding& operator=(const ObservableBinding&) = delete;
+
+    void bind(Observable<T>* observable, Callback callback)
+    {
+        this->unbind();
+
+        callback(observable->get());
+
+        this->subscription = observable->getChangeEvent()->subscribe(callback);
+        this->observable   = observable;
+    }
+
+    void unbind()
+    {
+        if (!this->observable)
+            return;
+
+        this->observable->getChangeEvent()->unsubscribe(this->subscription);
+        this->observable = nullptr;
+    }
+
+    bool isBound()
+    {
+        return this->observable != nullptr;
+    }
+
+  private:
+    Observable<T>* observable = nullptr;
+    typename Observable<T>::ChangeEvent::Subscription subscription;
+};
+
+} // namespace brls
@@ -0,0 +1,185 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace brls
+{
+
+// A contiguous vector storing its first N elements inline,
+// only allocating once it grows past that
+template <typename T, size_t N>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector needs at least one inline element");
+
+  public:
+    SmallVector() = default;
+
+    SmallVector(const SmallVector&) = delete;
+    SmallVector& operator=(const SmallVector&) = delete;
+
+    ~SmallVector()
+    {
+        this->clear();
+
+        if (this->items != this->inlineItems())
+            ::operator delete(this->items);
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (this->count == this->capacity)
+            this->grow();
+
+        T* item = new (this->items + this->count) T(std::forward<Args>(args)...);
+        this->count++;
+
+        return *item;
+    }
+
+    void push_back(T&& item)
+    {
+        this->emplace_back(std::move(item));
+    }
+
+    void pop_back()
+    {
+        this->items[--this->count].~T();
+    }
+
+    /**
+     * Removes the element at the given index,
+     * keeping the order of the others
+     */
+    void erase(size_t index)
+    {
+        for (size_t i = index; i + 1 < this->count; i++)
+            this->items[i] = std::move(this->items[i + 1]);
+
+        this->pop_back();
+    }
+
+    /**
+     * Removes all elements matching the given predicate,
+     * keeping the order of the others
+     */
+    template <typename Predicate>
+    void removeIf(Predicate predicate)
+    {
+        size_t kept = 0;
+
+        for (size_t i = 0; i < this->count; i++)
+        {
+            if (predicate(this->items[i]))
+                continue;
+
+            if (kept != i)
+                this->items[kept] = std::move(this->items[i]);
+
+            kept++;
+        }
+
+        while (this->count > kept)
+            this->pop_back();
+    }
+
+    void clear()
+    {
+        while (this->count > 0)
+            this->pop_back();
+    }
+
+    size_t size() const
+    {
+        return this->count;
+    }
+
+    bool empty() const
+    {
+        return this->count == 0;
+    }
+
+    T& operator[](size_t index)
+    {
+        return this->items[index];
+    }
+
+    const T& operator[](size_t index) const
+    {
+        return this->items[index];
+    }
+
+    T* begin()
+    {
+        return this->items;
+    }
+
+    T* end()
+    {
+        return this->items + this->count;
+    }
+
+    const T* begin() const
+    {
+        return this->items;
+    }
+
+    const T* end() const
+    {
+        return this->items + this->count;
+    }
+
+  private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[N];
+
+    T* items        = this->inlineItems();
+    size_t count    = 0;
+    size_t capacity = N;
+
+    T* inlineItems()
+    {
+        return reinterpret_cast<T*>(this->storage);
+    }
+
+    void grow()
+    {
+        size_t newCapacity = this->capacity * 2;
+        T* newItems        = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+
+        for (size_t i = 0; i < this->count; i++)
+        {
+            new (newItems + i) T(std::move(this->items[i]));
+            this->items[i].~T();
+        }
+
+        if (this->items != this->inlineItems())
+            ::operator delete(this->items);
+
+        this->items    = newItems;
+        this->capacity = newCapacity;
+    }
+};
+
+} // namespace brls
@@ -68,6 +68,19 @@ class View;
 typedef Event<View*> GenericEvent;
 typedef Event<> VoidEvent;
 
+// Rarely used data of a view, only allocated when
+// needed to keep views small (see View::getExtras)
+struct ViewExtras
+{
+    std::vector<Action> actions; // instance actions, overriding the ones of the table
+
+    GenericEvent focusEvent;
+
+    retro_time_t highlightShakeStart = 0;
+    FocusDirection highlightShakeDirection;
+    float highlightShakeAmplitude = 0.0f;
+};
+
 // Superclass for all the other views
 // Lifecycle of a view is :
 //   new -> [willAppear -> willDisappear] -> delete
@@ -79,29 +92,45 @@ typedef Event<> VoidEvent;
 // before deletion (in case of a TabLayout for instance)
 class View
 {
-  private:
-    ViewBackground background = ViewBackground::NONE;
+    // Data read by every frame traversal comes first so that it
+    // stays within the first cache line, see ViewExtras for the rest
 
-    void drawBackground(NVGcontext* vg, FrameContext* ctx, Style* style);
-    void drawHighlight(NVGcontext* vg, Theme* theme, float alpha, Style* style, bool background);
+  protected:
+    int x = 0;
+    int y = 0;
 
-    float highlightAlpha = 0.0f;
+    unsigned width  = 0;
+    unsigned height = 0;
 
-    bool dirty = true;
+    float collapseState = 1.0f;
 
-    bool highlightShaking = false;
-    retro_time_t highlightShakeStart;
-    FocusDirection highlightShakeDirection;
-    float highlightShakeAmplitude;
+  public:
+    float alpha = 1.0f;
+
+  private:
+    float highlightAlpha = 0.0f;
 
+    ViewBackground background = ViewBackground::NONE;
+
+    bool dirty            = true;
+    bool hidden           = false;
     bool fadeIn           = false; // is the fade in animation running?
     bool forceTranslucent = false;
+    bool highlightShaking = false;
 
+  protected:
+    bool focused = false;
+
+    View* parent = nullptr;
+
+  private:
     Theme* themeOverride = nullptr;
 
-    bool hidden = false;
+    uint32_t actionKeys = 0; // mask of the keys having an instance action, see getKeyMask
+
+    const ActionTable* actionTable = nullptr;
 
-    std::vector<Action> actions;
+    ViewExtras* extras = nullptr;
 
     /**
      * Parent user data, typically the index of the view
@@ -109,21 +138,18 @@ class View
      */
     void* parentUserdata = nullptr;
 
-  protected:
-    int x = 0;
-    int y = 0;
-
-    unsigned width  = 0;
-    unsigned height = 0;
-
-    float collapseState = 1.0f;
-
-    bool focused = false;
+    /**
+     * Returns the rarely used data of the view,
+     * allocating it on first use
+     */
+    ViewExtras* getExtras();
 
-    View* parent = nullptr;
+    void drawBackground(NVGcontext* vg, FrameContext* ctx, Style* style);
+    void drawHighlight(NVGcontext* vg, Theme* theme, float alpha, Style* style, bool background);
 
-    GenericEvent focusEvent;
+    Action* getOwnAction(Key key);
 
+  protected:
     virtual unsigned getShowAnimationDuration(ViewAnimation animation);
 
     virtual void getHighlightInsets(unsigned* top, unsigned* right, unsigned* bottom, unsigned* left)
@@ -201,16 +227,74 @@ class View
     void* getParentUserData();
 
     void registerAction(std::string hintText, Key key, ActionListener actionListener, bool hidden = false);
+    void registerAction(i18n::Translation hintText, Key key, ActionListener actionListener, bool hidden = false);
     void updateActionHint(Key key, std::string hintText);
+    void updateActionHint(Key key, i18n::Translation hintText);
     void setActionAvailable(Key key, bool available);
 
+    /**
+     * Sets the default actions of the view, typically a static table
+     * shared by all instances of a class
+     * Registered actions take precedence over the table, and updating
+     * an action of the table copies it to the view first
+     */
+    void setActionTable(const ActionTable* actionTable);
+
     std::string describe() const { return typeid(*this).name(); }
 
+    /**
+     * Returns the actions registered on this instance,
+     * without the ones of the action table
+     */
     const std::vector<Action>& getActions()
     {
-        return this->actions;
+        static const std::vector<Action> noActions;
+        return this->extras ? this->extras->actions : noActions;
     }
 
+    /**
+     * Calls the given callback for every action of
+     * the view, including the ones of the action table
+     */
+    template <typename Callback>
+    void forEachAction(Callback callback) const
+    {
+        if (this->extras)
+        {
+            for (const Action& action : this->extras->actions)
+                callback(action);
+        }
+
+        if (!this->actionTable)
+            return;
+
+        for (const Action& action : this->actionTable->getActions())
+        {
+            if (!(this->actionKeys & getKeyMask(action.key)))
+                callback(action);
+        }
+    }
+
+    /**
+     * Returns the action for the given key,
+     * or nullptr if there is none
+     */
+    const Action* getAction(Key key) const;
+
+    /**
+     * Returns the mask of the keys having an action, see getKeyMask
+     */
+    uint32_t getActionKeys() const
+    {
+        return this->actionKeys | (this->actionTable ? this->actionTable->getKeys() : 0);
+    }
+
+    /**
+     * Fires the given action of the view, returns
+     * its result
+     */
+    bool fireAction(const Action& action);
+
     /**
       * Called each frame
       * Do not override it to draw your view,
@@ -221,6 +305,11 @@ class View
     /**
       * Called by frame() to draw
       * the view onscreen
+      *
+      * The nanovg state is not saved around it: views changing
+      * the transform, the scissor or the line caps must restore
+      * them (with nvgSave() and nvgRestore() for instance),
+      * and views drawing text must set its font face, size and alignment
       */
     virtual void draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx) = 0;
 
@@ -306,6 +395,14 @@ class View
       */
     void invalidate(bool immediate = false);
 
+    /**
+      * To be called when the view looks different without
+      * needing a layout (animations), so that it's redrawn
+      * if it's part of the snapshot below an overlay
+      * invalidate() does it already
+      */
+    void invalidateDrawing();
+
     /**
       * Is this view translucent?
       *
@@ -379,6 +476,39 @@ class View
             this->getParent()->onChildFocusLost(this);
     }
 
+    /**
+     * Called once the view has been popped from the view stack,
+     * instead of deleting it
+     *
+     * Return true to keep the view alive, for instance
+     * in a pool to reuse it next time (see Dropdown)
+     */
+    virtual bool recycle()
+    {
+        return false;
+    }
+
+    /**
+     * Fired when a character is typed on the keyboard while this view
+     * or one of its children is focused, as a unicode codepoint
+     * Returns true if the character has been consumed, otherwise
+     * it goes to the parent
+     */
+    virtual bool onCharInput(unsigned int codepoint)
+    {
+        return false;
+    }
+
+    /**
+     * Should letter keys be typed instead of being mapped
+     * to gamepad buttons while this view or one of its
+     * children is focused? See onCharInput
+     */
+    virtual bool acceptsCharInput()
+    {
+        return false;
+    }
+
     /**
      * Fired when the window size changes
      * Not guaranteed to be called before or after layout()
@@ -390,8 +520,6 @@ class View
 
     GenericEvent* getFocusEvent();
 
-    float alpha = 1.0f;
-
     virtual float getAlpha(bool child = false);
 
     /**
@@ -400,6 +528,12 @@ class View
       */
     void overrideThemeVariant(Theme* newTheme);
 
+    View() = default;
+
+    // Views own their extras and are referenced by their parent
+    View(const View&) = delete;
+    View& operator=(const View&) = delete;
+
     virtual ~View();
 };
 
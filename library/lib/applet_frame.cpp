@@ -21,8 +21,6 @@
 #include <borealis/application.hpp>
 #include <borealis/i18n.hpp>
 
-using namespace brls::i18n::literals;
-
 namespace brls
 {
 
@@ -39,7 +37,11 @@ AppletFrame::AppletFrame(bool padLeft, bool padRight)
     this->hint = new Hint();
     this->hint->setParent(this);
 
-    this->registerAction("brls/hints/back"_i18n, Key::B, [this] { return this->onCancel(); });
+    static const ActionTable actions = {
+        memberAction(i18n::Translation("brls/hints/back"), Key::B, &AppletFrame::onCancel),
+    };
+
+    this->setActionTable(&actions);
 }
 
 void AppletFrame::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
@@ -135,6 +137,7 @@ void AppletFrame::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned he
         text = Application::getCommonFooter();
 
     nvgFontSize(vg, style->AppletFrame.footerTextSize);
+    nvgFontFaceId(vg, ctx->fontStash->regular);
     nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
     nvgBeginPath(vg);
     nvgText(vg, x + style->AppletFrame.separatorSpacing + style->AppletFrame.footerTextSpacing, y + height - style->AppletFrame.footerHeight / 2, text->c_str(), nullptr);
@@ -42,13 +42,13 @@
 #include <glm/vec4.hpp>
 #define NANOVG_GL3_IMPLEMENTATION
 #include <nanovg/nanovg_gl.h>
+#include <nanovg/nanovg_gl_utils.h>
 
 #ifdef __SWITCH__
 #include <switch.h>
 #endif
 
 #include <chrono>
-#include <set>
 #include <thread>
 
 // Constants used for scaling as well as
@@ -57,14 +57,11 @@ constexpr uint32_t WINDOW_WIDTH  = 1280;
 constexpr uint32_t WINDOW_HEIGHT = 720;
 
 #define DEFAULT_FPS 60
-#define BUTTON_REPEAT_DELAY 15
-#define BUTTON_REPEAT_CADENCY 5
+#define INPUT_POLL_INTERVAL 4000 // us, gamepad polling interval while waiting for the next frame
 
 // glfw code from the glfw hybrid app by fincs
 // https://github.com/fincs/hybrid_app
 
-using namespace brls::i18n::literals;
-
 namespace brls
 {
 
@@ -84,29 +81,35 @@ static void windowFramebufferSizeCallback(GLFWwindow* window, int width, int hei
 
     Application::resizeNotificationManager();
 
-    Logger::info("Window size changed to {}x{}", width, height);
-    Logger::info("New scale factor is {}", Application::windowScale);
+    BRLS_LOG_INFO("Window size changed to {}x{}", width, height);
+    BRLS_LOG_INFO("New scale factor is {}", Application::windowScale);
 }
 
 static void joystickCallback(int jid, int event)
 {
     if (event == GLFW_CONNECTED)
     {
-        Logger::info("Joystick {} connected", jid);
+        BRLS_LOG_INFO("Joystick {} connected", jid);
         if (glfwJoystickIsGamepad(jid))
-            Logger::info("Joystick {} is gamepad: \"{}\"", jid, glfwGetGamepadName(jid));
+            BRLS_LOG_INFO("Joystick {} is gamepad: \"{}\"", jid, glfwGetGamepadName(jid));
     }
     else if (event == GLFW_DISCONNECTED)
-        Logger::info("Joystick {} disconnected", jid);
+        BRLS_LOG_INFO("Joystick {} disconnected", jid);
 }
 
 static void errorCallback(int errorCode, const char* description)
 {
-    Logger::error("[GLFW:{}] {}", errorCode, description);
+    BRLS_LOG_ERROR("[GLFW:{}] {}", errorCode, description);
 }
 
 static void windowKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
+    // Letters are typed, not pressed as buttons (L and R would be both)
+    bool typed = action == GLFW_PRESS && key >= GLFW_KEY_A && key <= GLFW_KEY_Z && Application::isCharInputFocused();
+
+    if (!typed)
+        Application::getInputManager()->onKeyboardKey(key, action, cpu_features_get_time_usec());
+
     if (action == GLFW_PRESS)
     {
         // Check for toggle-fullscreen combo
@@ -134,6 +137,11 @@ static void windowKeyCallback(GLFWwindow* window, int key, int scancode, int act
     }
 }
 
+static void windowCharCallback(GLFWwindow* window, unsigned int codepoint)
+{
+    Application::getInputManager()->onCharInput(codepoint, cpu_features_get_time_usec());
+}
+
 bool Application::init(std::string title, Style* style, LibraryViewsThemeVariantsWrapper* themeVariantsWrapper)
 {
     // Init rng
@@ -142,11 +150,17 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
     // Init managers
     Application::taskManager         = new TaskManager();
     Application::notificationManager = new NotificationManager();
+    Application::inputManager        = new InputManager();
+
+    // Input recording and replay, for automated runs
+    if (const char* path = getenv("BRLS_INPUT_RECORD"))
+        Application::inputManager->startRecording(path);
+
+    if (const char* path = getenv("BRLS_INPUT_REPLAY"))
+        Application::inputManager->startReplay(path);
 
     // Init static variables
     Application::currentFocus = nullptr;
-    Application::oldGamepad   = {};
-    Application::gamepad      = {};
     Application::title        = title;
 
     // Init theme and style
@@ -164,7 +178,7 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
     glfwInitHint(GLFW_JOYSTICK_HAT_BUTTONS, GLFW_FALSE);
     if (!glfwInit())
     {
-        Logger::error("Failed to initialize glfw");
+        BRLS_LOG_ERROR("Failed to initialize glfw");
         return false;
     }
 
@@ -186,7 +200,7 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
     Application::window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, title.c_str(), nullptr, nullptr);
     if (!window)
     {
-        Logger::error("glfw: failed to create window");
+        BRLS_LOG_ERROR("glfw: failed to create window");
         glfwTerminate();
         return false;
     }
@@ -196,20 +210,21 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, windowFramebufferSizeCallback);
     glfwSetKeyCallback(window, windowKeyCallback);
+    glfwSetCharCallback(window, windowCharCallback);
     glfwSetJoystickCallback(joystickCallback);
 
     // Load OpenGL routines using glad
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
     glfwSwapInterval(1);
 
-    Logger::info("GL Vendor: {}", glGetString(GL_VENDOR));
-    Logger::info("GL Renderer: {}", glGetString(GL_RENDERER));
-    Logger::info("GL Version: {}", glGetString(GL_VERSION));
+    BRLS_LOG_INFO("GL Vendor: {}", (const char*)glGetString(GL_VENDOR));
+    BRLS_LOG_INFO("GL Renderer: {}", (const char*)glGetString(GL_RENDERER));
+    BRLS_LOG_INFO("GL Version: {}", (const char*)glGetString(GL_VERSION));
 
     if (glfwJoystickIsGamepad(GLFW_JOYSTICK_1))
     {
         GLFWgamepadstate state;
-        Logger::info("Gamepad detected: {}", glfwGetGamepadName(GLFW_JOYSTICK_1));
+        BRLS_LOG_INFO("Gamepad detected: {}", glfwGetGamepadName(GLFW_JOYSTICK_1));
         glfwGetGamepadState(GLFW_JOYSTICK_1, &state);
     }
 
@@ -217,7 +232,7 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
     Application::vg = nvgCreateGL3(NVG_STENCIL_STROKES | NVG_ANTIALIAS);
     if (!vg)
     {
-        Logger::error("Unable to init nanovg");
+        BRLS_LOG_ERROR("Unable to init nanovg");
         glfwTerminate();
         return false;
     }
@@ -234,7 +249,7 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
         Result rc = plGetSharedFontByType(&font, PlSharedFontType_Standard);
         if (R_SUCCEEDED(rc))
         {
-            Logger::info("Using Switch shared font");
+            BRLS_LOG_INFO("Using Switch shared font");
             Application::fontStash.regular = Application::loadFontFromMemory("regular", font.address, font.size, false);
         }
 
@@ -242,7 +257,7 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
         rc = plGetSharedFontByType(&font, PlSharedFontType_KO);
         if (R_SUCCEEDED(rc))
         {
-            Logger::info("Adding Switch shared Korean font");
+            BRLS_LOG_INFO("Adding Switch shared Korean font");
             Application::fontStash.korean = Application::loadFontFromMemory("korean", font.address, font.size, false);
             nvgAddFallbackFontId(Application::vg, Application::fontStash.regular, Application::fontStash.korean);
         }
@@ -251,7 +266,7 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
         rc = plGetSharedFontByType(&font, PlSharedFontType_NintendoExt);
         if (R_SUCCEEDED(rc))
         {
-            Logger::info("Using Switch shared symbols font");
+            BRLS_LOG_INFO("Using Switch shared symbols font");
             Application::fontStash.sharedSymbols = Application::loadFontFromMemory("symbols", font.address, font.size, false);
         }
     }
@@ -263,7 +278,7 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
         Application::fontStash.regular = Application::loadFont("regular", BOREALIS_ASSET("inter/Inter-Switch.ttf"));
 
     if (Application::fontStash.regular == -1)
-        brls::Logger::warning("Couldn't load regular font, no text will be displayed!");
+        BRLS_LOG_WARNING("Couldn't load regular font, no text will be displayed!");
 
     if (access(BOREALIS_ASSET("Wingdings.ttf"), F_OK) != -1)
         Application::fontStash.sharedSymbols = Application::loadFont("sharedSymbols", BOREALIS_ASSET("Wingdings.ttf"));
@@ -276,23 +291,23 @@ bool Application::init(std::string title, Style* style, LibraryViewsThemeVariant
     // Set symbols font as fallback
     if (Application::fontStash.sharedSymbols)
     {
-        Logger::info("Using shared symbols font");
+        BRLS_LOG_INFO("Using shared symbols font");
         nvgAddFallbackFontId(Application::vg, Application::fontStash.regular, Application::fontStash.sharedSymbols);
     }
     else
     {
-        Logger::warning("Shared symbols font not found");
+        BRLS_LOG_WARNING("Shared symbols font not found");
     }
 
     // Set Material as fallback
     if (Application::fontStash.material)
     {
-        Logger::info("Using Material font");
+        BRLS_LOG_INFO("Using Material font");
         nvgAddFallbackFontId(Application::vg, Application::fontStash.regular, Application::fontStash.material);
     }
     else
     {
-        Logger::warning("Material font not found");
+        BRLS_LOG_WARNING("Material font not found");
     }
 
     // Load theme
@@ -361,52 +376,10 @@ bool Application::mainLoop()
     }
 #endif
 
-    // Gamepad
-    if (!glfwGetGamepadState(GLFW_JOYSTICK_1, &Application::gamepad))
-    {
-        // Keyboard -> DPAD Mapping
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_DPAD_LEFT]    = glfwGetKey(window, GLFW_KEY_LEFT);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_DPAD_RIGHT]   = glfwGetKey(window, GLFW_KEY_RIGHT);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_DPAD_UP]      = glfwGetKey(window, GLFW_KEY_UP);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_DPAD_DOWN]    = glfwGetKey(window, GLFW_KEY_DOWN);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_START]        = glfwGetKey(window, GLFW_KEY_ESCAPE);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_BACK]         = glfwGetKey(window, GLFW_KEY_F1);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_A]            = glfwGetKey(window, GLFW_KEY_ENTER);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_B]            = glfwGetKey(window, GLFW_KEY_BACKSPACE);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_LEFT_BUMPER]  = glfwGetKey(window, GLFW_KEY_L);
-        Application::gamepad.buttons[GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER] = glfwGetKey(window, GLFW_KEY_R);
-    }
-
-    // Trigger gamepad events
-    // TODO: Translate axis events to dpad events here
-
-    bool anyButtonPressed               = false;
-    bool repeating                      = false;
-    static retro_time_t buttonPressTime = 0;
-    static int repeatingButtonTimer     = 0;
-
-    for (int i = GLFW_GAMEPAD_BUTTON_A; i <= GLFW_GAMEPAD_BUTTON_LAST; i++)
-    {
-        if (Application::gamepad.buttons[i] == GLFW_PRESS)
-        {
-            anyButtonPressed = true;
-            repeating        = (repeatingButtonTimer > BUTTON_REPEAT_DELAY && repeatingButtonTimer % BUTTON_REPEAT_CADENCY == 0);
-
-            if (Application::oldGamepad.buttons[i] != GLFW_PRESS || repeating)
-                Application::onGamepadButtonPressed(i, repeating);
-        }
-
-        if (Application::gamepad.buttons[i] != Application::oldGamepad.buttons[i])
-            buttonPressTime = repeatingButtonTimer = 0;
-    }
-
-    if (anyButtonPressed && cpu_features_get_time_usec() - buttonPressTime > 1000)
-    {
-        buttonPressTime = cpu_features_get_time_usec();
-        repeatingButtonTimer++; // Increased once every ~1ms
-    }
-
-    Application::oldGamepad = Application::gamepad;
+    // Inputs
+    retro_time_t now = cpu_features_get_time_usec();
+    Application::inputManager->pollGamepad(now);
+    Application::inputManager->update(now);
 
     // Handle window size changes
     GLint viewport[4];
@@ -428,20 +401,34 @@ bool Application::mainLoop()
     // Tasks
     Application::taskManager->frame();
 
+    // Bindings
+    ObservableBase::flushAll();
+
     // Render
     Application::frame();
     glfwSwapBuffers(window);
 
+    static bool firstFrame = true;
+    if (firstFrame)
+    {
+        i18n::internal::onFirstFrame();
+        firstFrame = false;
+    }
+
     // Sleep if necessary
     if (Application::frameTime > 0.0f)
     {
         retro_time_t currentFrameTime = cpu_features_get_time_usec() - frameStart;
         retro_time_t frameTime        = (retro_time_t)(Application::frameTime * 1000);
 
-        if (frameTime > currentFrameTime)
+        // Keep polling the gamepad while waiting so that short presses aren't missed
+        while (frameTime > currentFrameTime)
         {
-            retro_time_t toSleep = frameTime - currentFrameTime;
+            retro_time_t toSleep = std::min(frameTime - currentFrameTime, (retro_time_t)INPUT_POLL_INTERVAL);
             std::this_thread::sleep_for(std::chrono::microseconds(toSleep));
+
+            Application::inputManager->pollGamepad(cpu_features_get_time_usec());
+            currentFrameTime = cpu_features_get_time_usec() - frameStart;
         }
     }
 
@@ -453,14 +440,11 @@ void Application::quit()
     glfwSetWindowShouldClose(window, GLFW_TRUE);
 }
 
-void Application::navigate(FocusDirection direction)
+View* Application::findNextFocus(View* currentFocus, FocusDirection direction)
 {
-    View* currentFocus = Application::currentFocus;
-
-    // Do nothing if there is no current focus or if it doesn't have a parent
-    // (in which case there is nothing to traverse)
-    if (!currentFocus || !currentFocus->hasParent())
-        return;
+    // Nothing to traverse if the view doesn't have a parent
+    if (!currentFocus->hasParent())
+        return nullptr;
 
     // Get next view to focus by traversing the views tree upwards
     View* nextFocus = currentFocus->getParent()->getNextFocus(direction, currentFocus);
@@ -474,10 +458,33 @@ void Application::navigate(FocusDirection direction)
         nextFocus    = currentFocus->getParent()->getNextFocus(direction, currentFocus);
     }
 
+    return nextFocus;
+}
+
+void Application::navigate(FocusDirection direction, unsigned steps)
+{
+    // Do nothing if there is no current focus
+    if (!Application::currentFocus)
+        return;
+
+    // Walk all the steps first to only give focus once
+    View* nextFocus = Application::currentFocus;
+
+    for (unsigned i = 0; i < steps; i++)
+    {
+        View* stepFocus = Application::findNextFocus(nextFocus, direction);
+
+        if (!stepFocus)
+            break;
+
+        nextFocus = stepFocus;
+    }
+
     // No view to focus at the end of the traversal: wiggle and return
-    if (!nextFocus)
+    if (nextFocus == Application::currentFocus)
     {
-        Application::currentFocus->shakeHighlight(direction);
+        if (Application::currentFocus->hasParent())
+            Application::currentFocus->shakeHighlight(direction);
         return;
     }
 
@@ -485,7 +492,7 @@ void Application::navigate(FocusDirection direction)
     Application::giveFocus(nextFocus);
 }
 
-void Application::onGamepadButtonPressed(char button, bool repeating)
+void Application::onGamepadButtonPressed(char button, bool repeating, unsigned steps)
 {
     if (Application::blockInputsTokens != 0)
         return;
@@ -497,7 +504,13 @@ void Application::onGamepadButtonPressed(char button, bool repeating)
 
     // Actions
     if (Application::handleAction(button))
+    {
+        // Steps are only coalesced for navigation, actions get all of them
+        for (unsigned i = 1; i < steps; i++)
+            Application::handleAction(button);
+
         return;
+    }
 
     // Navigation
     // Only navigate if the button hasn't been consumed by an action
@@ -505,57 +518,123 @@ void Application::onGamepadButtonPressed(char button, bool repeating)
     switch (button)
     {
         case GLFW_GAMEPAD_BUTTON_DPAD_DOWN:
-            Application::navigate(FocusDirection::DOWN);
+            Application::navigate(FocusDirection::DOWN, steps);
             break;
         case GLFW_GAMEPAD_BUTTON_DPAD_UP:
-            Application::navigate(FocusDirection::UP);
+            Application::navigate(FocusDirection::UP, steps);
             break;
         case GLFW_GAMEPAD_BUTTON_DPAD_LEFT:
-            Application::navigate(FocusDirection::LEFT);
+            Application::navigate(FocusDirection::LEFT, steps);
             break;
         case GLFW_GAMEPAD_BUTTON_DPAD_RIGHT:
-            Application::navigate(FocusDirection::RIGHT);
+            Application::navigate(FocusDirection::RIGHT, steps);
             break;
         default:
             break;
     }
 }
 
+void Application::onCharInput(unsigned int codepoint)
+{
+    if (Application::blockInputsTokens != 0)
+        return;
+
+    for (View* view = Application::currentFocus; view; view = view->getParent())
+    {
+        if (view->onCharInput(codepoint))
+            return;
+    }
+}
+
+bool Application::isCharInputFocused()
+{
+    for (View* view = Application::currentFocus; view; view = view->getParent())
+    {
+        if (view->acceptsCharInput())
+            return true;
+    }
+
+    return false;
+}
+
 View* Application::getCurrentFocus()
 {
     return Application::currentFocus;
 }
 
-bool Application::handleAction(char button)
+void Application::invalidateActionChain()
 {
+    Application::actionChainDirty = true;
+}
+
+void Application::rebuildActionChain()
+{
+    for (std::vector<View*>& chain : Application::actionChains)
+        chain.clear(); // keeps the capacity, no reallocation once warmed up
+
+    Application::actionChainKeys  = 0;
+    Application::actionChainDirty = false;
+
     if (Application::viewStack.empty())
-        return false;
+        return;
 
     View* hintParent = Application::currentFocus;
-    std::set<Key> consumedKeys;
 
     if (!hintParent)
         hintParent = Application::viewStack[Application::viewStack.size() - 1];
 
     while (hintParent)
     {
-        for (auto& action : hintParent->getActions())
-        {
-            if (action.key != static_cast<Key>(button))
-                continue;
+        hintParent->forEachAction([hintParent](const Action& action) {
+            Application::actionChains[(unsigned)action.key].push_back(hintParent);
+        });
 
-            if (consumedKeys.find(action.key) != consumedKeys.end())
-                continue;
+        Application::actionChainKeys |= hintParent->getActionKeys();
+        hintParent = hintParent->getParent();
+    }
 
-            if (action.available)
-                if (action.actionListener())
-                    consumedKeys.insert(action.key);
-        }
+    Application::actionChainKeys |= Application::getGlobalActions()->getKeys();
+}
 
-        hintParent = hintParent->getParent();
+const ActionTable* Application::getGlobalActions()
+{
+    static const ActionTable globalActions = {
+        { Key::PLUS, "", true, false, [] { Application::quit(); return true; }, i18n::Translation("brls/hints/exit") },
+        { Key::MINUS, "FPS", true, true, [] { Application::toggleFramerateDisplay(); return true; }, std::nullopt },
+    };
+
+    return &globalActions;
+}
+
+bool Application::handleAction(char button)
+{
+    if (Application::actionChainDirty)
+        Application::rebuildActionChain();
+
+    Key key = static_cast<Key>(button);
+
+    if (!(Application::actionChainKeys & getKeyMask(key)))
+        return false;
+
+    unsigned generation = Application::focusGeneration;
+
+    for (View* view : Application::actionChains[(unsigned)key])
+    {
+        const Action* action = view->getAction(key);
+
+        if (action && action->available && view->fireAction(*action))
+            return true;
+
+        // The listener changed the focus or the views: the rest
+        // of the chain may not exist anymore
+        // Other changes (such as registered actions) don't affect it
+        if (Application::focusGeneration != generation)
+            return false;
     }
 
-    return !consumedKeys.empty();
+    const Action* globalAction = Application::getGlobalActions()->find(key);
+
+    return globalAction && globalAction->available && globalAction->actionListener();
 }
 
 void Application::frame()
@@ -568,6 +647,21 @@ void Application::frame()
     frameContext.fontStash  = &Application::fontStash;
     frameContext.theme      = Application::getTheme();
 
+    std::vector<View*> viewsToDraw;
+
+    // Draw all views in the stack
+    // until we find one that's not translucent
+    for (size_t i = 0; i < Application::viewStack.size(); i++)
+    {
+        View* view = Application::viewStack[Application::viewStack.size() - 1 - i];
+        viewsToDraw.push_back(view);
+
+        if (!view->isTranslucent())
+            break;
+    }
+
+    bool useSnapshot = Application::updateSnapshot(&viewsToDraw, &frameContext);
+
     // GL Clear
     glClearColor(
         frameContext.theme->backgroundColor[0],
@@ -583,26 +677,28 @@ void Application::frame()
     nvgBeginFrame(Application::vg, Application::windowWidth, Application::windowHeight, frameContext.pixelRatio);
     nvgScale(Application::vg, Application::windowScale, Application::windowScale);
 
-    std::vector<View*> viewsToDraw;
+    if (Application::background)
+        Application::background->frame(&frameContext);
 
-    // Draw all views in the stack
-    // until we find one that's not translucent
-    for (size_t i = 0; i < Application::viewStack.size(); i++)
+    if (useSnapshot)
     {
-        View* view = Application::viewStack[Application::viewStack.size() - 1 - i];
-        viewsToDraw.push_back(view);
+        // Views below the top one, as one image
+        NVGpaint snapshotPaint = nvgImagePattern(Application::vg, 0, 0, Application::contentWidth, Application::contentHeight, 0, Application::snapshot->image, 1.0f);
 
-        if (!view->isTranslucent())
-            break;
-    }
+        nvgBeginPath(Application::vg);
+        nvgRect(Application::vg, 0, 0, Application::contentWidth, Application::contentHeight);
+        nvgFillPaint(Application::vg, snapshotPaint);
+        nvgFill(Application::vg);
 
-    if (Application::background)
-        Application::background->frame(&frameContext);
-
-    for (size_t i = 0; i < viewsToDraw.size(); i++)
+        viewsToDraw[0]->frame(&frameContext);
+    }
+    else
     {
-        View* view = viewsToDraw[viewsToDraw.size() - 1 - i];
-        view->frame(&frameContext);
+        for (size_t i = 0; i < viewsToDraw.size(); i++)
+        {
+            View* view = viewsToDraw[viewsToDraw.size() - 1 - i];
+            view->frame(&frameContext);
+        }
     }
 
     // Framerate counter
@@ -620,10 +716,99 @@ void Application::frame()
         Application::background->postFrame();
 }
 
+bool Application::updateSnapshot(std::vector<View*>* viewsToDraw, FrameContext* frameContext)
+{
+    // Only snapshot once the top view is translucent and fully shown,
+    // the views below are animated while it's being pushed or popped
+    View* overlay = viewsToDraw->size() > 1 ? (*viewsToDraw)[0] : nullptr;
+
+    if (!overlay || overlay->isHidden() || overlay->getAlpha() < 1.0f || Application::background || Application::snapshotFailed)
+    {
+        Application::snapshotOverlay = nullptr;
+        Application::snapshotDirty   = true;
+        return false;
+    }
+
+    if (overlay != Application::snapshotOverlay || frameContext->theme != Application::snapshotTheme)
+        Application::snapshotDirty = true;
+
+    if (!Application::snapshotDirty)
+        return true;
+
+    if (!Application::snapshot)
+    {
+        Application::snapshot = nvgluCreateFramebuffer(Application::vg, Application::windowWidth, Application::windowHeight, 0);
+
+        if (!Application::snapshot)
+        {
+            BRLS_LOG_WARNING("Cannot create the views snapshot framebuffer, drawing every view on every frame");
+            Application::snapshotFailed = true;
+            return false;
+        }
+    }
+
+    // Render the views below the top one
+    nvgluBindFramebuffer(Application::snapshot);
+
+    glClearColor(
+        frameContext->theme->backgroundColor[0],
+        frameContext->theme->backgroundColor[1],
+        frameContext->theme->backgroundColor[2],
+        1.0f);
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    nvgBeginFrame(Application::vg, Application::windowWidth, Application::windowHeight, frameContext->pixelRatio);
+    nvgScale(Application::vg, Application::windowScale, Application::windowScale);
+
+    for (size_t i = viewsToDraw->size() - 1; i > 0; i--)
+        (*viewsToDraw)[i]->frame(frameContext);
+
+    nvgResetTransform(Application::vg); // scale
+    nvgEndFrame(Application::vg);
+
+    nvgluBindFramebuffer(nullptr);
+
+    // Invalidations while drawing are layouts done by frame(), the snapshot is up to date
+    Application::snapshotOverlay = overlay;
+    Application::snapshotTheme   = frameContext->theme;
+    Application::snapshotDirty   = false;
+
+    return true;
+}
+
+void Application::invalidateSnapshot(View* view)
+{
+    if (!Application::snapshotOverlay || Application::snapshotDirty)
+        return;
+
+    View* root = view;
+    while (root->hasParent())
+        root = root->getParent();
+
+    if (root != Application::snapshotOverlay)
+        Application::snapshotDirty = true;
+}
+
+void Application::deleteSnapshot()
+{
+    if (Application::snapshot)
+        nvgluDeleteFramebuffer(Application::snapshot);
+
+    Application::snapshot        = nullptr;
+    Application::snapshotOverlay = nullptr;
+    Application::snapshotDirty   = true;
+}
+
 void Application::exit()
 {
     Application::clear();
 
+    Dropdown::clearPool();
+
+    Decorations::clear();
+    Application::deleteSnapshot();
+
     if (Application::vg)
         nvgDeleteGL3(Application::vg);
 
@@ -636,22 +821,24 @@ void Application::exit()
 
     delete Application::taskManager;
     delete Application::notificationManager;
+    delete Application::inputManager;
 
     delete Application::currentThemeVariantsWrapper;
     delete Application::currentStyle;
+    Logger::flush();
 }
 
 void Application::setDisplayFramerate(bool enabled)
 {
     if (!Application::framerateCounter && enabled)
     {
-        Logger::debug("Enabling framerate counter");
+        BRLS_LOG_DEBUG("Enabling framerate counter");
         Application::framerateCounter = new FramerateCounter();
         Application::resizeFramerateCounter();
     }
     else if (Application::framerateCounter && !enabled)
     {
-        Logger::debug("Disabling framerate counter");
+        BRLS_LOG_DEBUG("Disabling framerate counter");
         delete Application::framerateCounter;
         Application::framerateCounter = nullptr;
     }
@@ -706,12 +893,14 @@ void Application::giveFocus(View* view)
             oldFocus->onFocusLost();
 
         Application::currentFocus = newFocus;
+        Application::focusGeneration++;
+        Application::invalidateActionChain();
         Application::globalFocusChangeEvent.fire(newFocus);
 
         if (newFocus)
         {
             newFocus->onFocusGained();
-            Logger::debug("Giving focus to {}", newFocus->describe());
+            BRLS_LOG_DEBUG("Giving focus to {}", newFocus->describe());
         }
     }
 }
@@ -734,7 +923,11 @@ void Application::popView(ViewAnimation animation, std::function<void(void)> cb)
     last->hide([last, animation, wait, cb]() {
         last->setForceTranslucent(false);
         Application::viewStack.pop_back();
-        delete last;
+        Application::focusGeneration++;
+        Application::invalidateActionChain();
+
+        if (!last->recycle())
+            delete last;
 
         // Animate the old view once the new one
         // has ended its animation
@@ -770,7 +963,7 @@ void Application::popView(ViewAnimation animation, std::function<void(void)> cb)
     {
         View* newFocus = Application::focusStack[Application::focusStack.size() - 1];
 
-        Logger::debug("Giving focus to {}, and removing it from the focus stack", newFocus->describe());
+        BRLS_LOG_DEBUG("Giving focus to {}, and removing it from the focus stack", newFocus->describe());
 
         Application::giveFocus(newFocus);
         Application::focusStack.pop_back();
@@ -790,10 +983,6 @@ void Application::pushView(View* view, ViewAnimation animation)
     bool fadeOut = last && !last->isTranslucent() && !view->isTranslucent(); // play the fade out animation?
     bool wait    = animation == ViewAnimation::FADE; // wait for the old view animation to be done before showing the new one?
 
-    view->registerAction("brls/hints/exit"_i18n, Key::PLUS, [] { Application::quit(); return true; });
-    view->registerAction(
-        "FPS", Key::MINUS, [] { Application::toggleFramerateDisplay(); return true; }, true);
-
     // Fade out animation
     if (fadeOut)
     {
@@ -830,7 +1019,7 @@ void Application::pushView(View* view, ViewAnimation animation)
     // Focus
     if (Application::viewStack.size() > 0 && Application::currentFocus != nullptr)
     {
-        Logger::debug("Pushing {} to the focus stack", Application::currentFocus->describe());
+        BRLS_LOG_DEBUG("Pushing {} to the focus stack", Application::currentFocus->describe());
         Application::focusStack.push_back(Application::currentFocus);
     }
 
@@ -841,11 +1030,16 @@ void Application::pushView(View* view, ViewAnimation animation)
 
     // And push it
     Application::viewStack.push_back(view);
+    Application::focusGeneration++;
+    Application::invalidateActionChain();
 }
 
 void Application::onWindowSizeChanged()
 {
-    Logger::debug("Layout triggered");
+    BRLS_LOG_DEBUG("Layout triggered");
+
+    Application::deleteSnapshot(); // the framebuffer has the window size
+    Decorations::clear(); // textures are rendered at the window scale
 
     for (View* view : Application::viewStack)
     {
@@ -880,6 +1074,7 @@ void Application::clear()
     }
 
     Application::viewStack.clear();
+    Application::focusGeneration++;
 }
 
 Style* Application::getStyle()
@@ -919,6 +1114,9 @@ int Application::findFont(const char* fontName)
 
 void Application::crash(std::string text)
 {
+    BRLS_LOG_ERROR("Crash: {}", text);
+    Logger::flush();
+
     CrashFrame* crashFrame = new CrashFrame(text);
     Application::pushView(crashFrame);
 }
@@ -939,6 +1137,11 @@ NVGcontext* Application::getNVGContext()
     return Application::vg;
 }
 
+InputManager* Application::getInputManager()
+{
+    return Application::inputManager;
+}
+
 TaskManager* Application::getTaskManager()
 {
     return Application::taskManager;
@@ -977,11 +1180,18 @@ void FramerateCounter::frame(FrameContext* ctx)
         this->setText(std::string(fps));
         this->invalidate(); // update width for background
 
-        this->frames     = 0;
-        this->lastSecond = current;
+        if (this->frames > 0)
+            BRLS_LOG_DEBUG("Views nanovg state saves: {} per frame, {} avoided per frame", this->stateSaves / this->frames, this->stateSavesAvoided / this->frames);
+
+        this->frames            = 0;
+        this->stateSaves        = 0;
+        this->stateSavesAvoided = 0;
+        this->lastSecond        = current;
     }
 
     this->frames++;
+    this->stateSaves += ctx->stateSaves;
+    this->stateSavesAvoided += ctx->stateSavesAvoided;
 
     // Regular frame
     Label::frame(ctx);
@@ -996,7 +1206,7 @@ void Application::setMaximumFPS(unsigned fps)
         Application::frameTime = 1000 / (float)fps;
     }
 
-    Logger::info("Maximum FPS set to {} - using a frame time of {:.2f} ms", fps, Application::frameTime);
+    BRLS_LOG_INFO("Maximum FPS set to {} - using a frame time of {:.2f} ms", fps, Application::frameTime);
 }
 
 std::string Application::getTitle()
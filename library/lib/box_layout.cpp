@@ -19,13 +19,17 @@
 */
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <borealis/animations.hpp>
 #include <borealis/application.hpp>
 #include <borealis/box_layout.hpp>
 #include <borealis/logger.hpp>
 #include <iterator>
+#include <string_view>
+#include <unordered_map>
 
 namespace brls
 {
@@ -150,6 +154,127 @@ void BoxLayout::clear(bool free)
         this->removeView(0, free);
 }
 
+void BoxLayout::reconcile(const BoxLayoutBuilder& builder)
+{
+    std::vector<BoxLayoutChild*> oldChildren = std::move(this->children);
+    std::vector<size_t> newIndices(oldChildren.size(), SIZE_MAX); // SIZE_MAX if removed
+
+    std::unordered_map<std::string_view, size_t> oldIndices;
+    oldIndices.reserve(oldChildren.size());
+
+    for (size_t i = 0; i < oldChildren.size(); i++)
+        oldIndices.emplace(oldChildren[i]->key, i);
+
+    size_t created = 0, updated = 0, moved = 0, removed = 0;
+
+    this->children.clear();
+    this->children.reserve(builder.entries.size());
+
+    for (const BoxLayoutBuilder::Entry& entry : builder.entries)
+    {
+        size_t index = this->children.size();
+        auto it      = oldIndices.find(entry.key);
+
+        // Existing child: only touch it if needed
+        if (it != oldIndices.end() && newIndices[it->second] == SIZE_MAX)
+        {
+            BoxLayoutChild* child  = oldChildren[it->second];
+            newIndices[it->second] = index;
+
+            if (it->second != index)
+            {
+                *((size_t*)child->view->getParentUserData()) = index;
+                moved++;
+            }
+
+            if (child->revision != entry.revision)
+            {
+                child->revision = entry.revision;
+
+                if (entry.update)
+                    entry.update(child->view);
+
+                updated++;
+            }
+
+            child->fill = entry.fill;
+            this->children.push_back(child);
+            continue;
+        }
+
+        if (it != oldIndices.end())
+            BRLS_LOG_WARNING("Duplicate key \"{}\" given to BoxLayout::reconcile", entry.key);
+
+        // New child
+        BoxLayoutChild* child = new BoxLayoutChild();
+        child->view           = entry.create();
+        child->fill           = entry.fill;
+        child->key            = entry.key;
+        child->revision       = entry.revision;
+
+        this->children.push_back(child);
+
+        size_t* userdata = (size_t*)malloc(sizeof(size_t));
+        *userdata        = index;
+
+        child->view->setParent(this, userdata);
+
+        if (entry.update)
+            entry.update(child->view);
+
+        child->view->willAppear(false);
+        created++;
+    }
+
+    // Follow the remembered focus
+    if (this->defaultFocusedIndex < oldChildren.size() && newIndices[this->defaultFocusedIndex] != SIZE_MAX)
+        this->defaultFocusedIndex = newIndices[this->defaultFocusedIndex];
+
+    // Move the focus away from the removed children before deleting them
+    View* focus = Application::getCurrentFocus();
+
+    for (size_t i = 0; i < oldChildren.size(); i++)
+    {
+        if (newIndices[i] != SIZE_MAX)
+            continue;
+
+        bool focused = false;
+        for (View* view = focus; view && !focused; view = view->getParent())
+            focused = view == oldChildren[i]->view;
+
+        if (focused && !this->children.empty())
+        {
+            size_t start   = std::min(i, this->children.size() - 1);
+            View* newFocus = nullptr;
+
+            for (size_t j = start; j < this->children.size() && !newFocus; j++)
+                newFocus = this->children[j]->view->getDefaultFocus();
+
+            for (size_t j = start; j-- > 0 && !newFocus;)
+                newFocus = this->children[j]->view->getDefaultFocus();
+
+            if (newFocus)
+                Application::giveFocus(newFocus);
+        }
+    }
+
+    for (size_t i = 0; i < oldChildren.size(); i++)
+    {
+        if (newIndices[i] != SIZE_MAX)
+            continue;
+
+        oldChildren[i]->view->willDisappear(true);
+        delete oldChildren[i]->view;
+        delete oldChildren[i];
+        removed++;
+    }
+
+    if (created > 0 || updated > 0 || moved > 0 || removed > 0)
+        this->invalidate();
+
+    BRLS_LOG_DEBUG("Reconciled {} children: {} created, {} updated, {} moved, {} removed", this->children.size(), created, updated, moved, removed);
+}
+
 void BoxLayout::layout(NVGcontext* vg, Style* style, FontStash* stash)
 {
     // Vertical orientation
@@ -22,8 +22,7 @@
 #include <borealis/application.hpp>
 #include <borealis/button.hpp>
 #include <borealis/i18n.hpp>
-
-using namespace brls::i18n::literals;
+#include <borealis/nine_slice.hpp>
 
 namespace brls
 {
@@ -34,7 +33,11 @@ namespace brls
 Button::Button(ButtonStyle style)
     : style(style)
 {
-    this->registerAction("brls/hints/ok"_i18n, Key::A, [this] { return this->onClick(); });
+    static const ActionTable actions = {
+        memberAction(i18n::Translation("brls/hints/ok"), Key::A, &Button::onClick),
+    };
+
+    this->setActionTable(&actions);
 }
 
 LabelStyle Button::getLabelStyle()
@@ -113,6 +116,14 @@ Button* Button::setLabel(std::string label)
     return this;
 }
 
+Button* Button::setLabel(i18n::Translation label)
+{
+    this->setLabel("");
+    this->label->setText(label);
+
+    return this;
+}
+
 Button* Button::setImage(std::string path)
 {
     this->image = new Image(path);
@@ -132,6 +143,8 @@ void Button::setState(ButtonState state)
     this->state = state;
     if (this->label != nullptr)
         this->label->setStyle(this->getLabelStyle());
+
+    this->invalidateDrawing();
 }
 
 ButtonState Button::getState()
@@ -205,19 +218,9 @@ void Button::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height,
         float shadowOpacity = style->Button.shadowOpacity;
         float shadowOffset  = style->Button.shadowOffset;
 
-        NVGpaint shadowPaint = nvgBoxGradient(vg,
-            x, y + shadowWidth,
-            width, height,
-            cornerRadius * 2, shadowFeather,
-            RGBA(0, 0, 0, shadowOpacity * alpha), transparent);
-
-        nvgBeginPath(vg);
-        nvgRect(vg, x - shadowOffset, y - shadowOffset,
-            width + shadowOffset * 2, height + shadowOffset * 3);
-        nvgRoundedRect(vg, x, y, width, height, cornerRadius);
-        nvgPathWinding(vg, NVG_HOLE);
-        nvgFillPaint(vg, shadowPaint);
-        nvgFill(vg);
+        Decorations::drawShadow(vg, x, y, width, height,
+            cornerRadius, shadowWidth, shadowFeather, shadowOffset,
+            RGBA(0, 0, 0, shadowOpacity * alpha));
     }
 
     // Label
@@ -247,5 +250,7 @@ void Button::setCornerRadius(float cornerRadius)
 
     if (this->image != nullptr)
         this->image->setCornerRadius(cornerRadius);
+
+    this->invalidateDrawing();
 }
 } // namespace brls
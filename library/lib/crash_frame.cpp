@@ -24,8 +24,6 @@
 #include <borealis/crash_frame.hpp>
 #include <borealis/i18n.hpp>
 
-using namespace brls::i18n::literals;
-
 namespace brls
 {
 
@@ -37,7 +35,7 @@ CrashFrame::CrashFrame(std::string text)
     this->label->setParent(this);
 
     // Button
-    this->button = (new Button(ButtonStyle::CRASH))->setLabel("brls/crash_frame/button"_i18n);
+    this->button = (new Button(ButtonStyle::CRASH))->setLabel(i18n::Translation("brls/crash_frame/button"));
     this->button->setParent(this);
     this->button->alpha = 0.0f;
     this->button->getClickEvent()->subscribe([](View* view) { Application::quit(); });
@@ -77,6 +75,7 @@ void CrashFrame::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned hei
     nvgFillColor(vg, RGB(255, 255, 255));
 
     nvgFontSize(vg, (float)style->CrashFrame.boxSize / 1.25f);
+    nvgFontFaceId(vg, ctx->fontStash->regular);
     nvgTextAlign(vg, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
     nvgBeginPath(vg);
     nvgText(vg, x + width / 2, y + style->CrashFrame.boxSpacing + boxSize / 2, "!", nullptr);
@@ -92,6 +91,7 @@ void CrashFrame::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned hei
     nvgFill(vg);
 
     nvgFontSize(vg, style->AppletFrame.footerTextSize);
+    nvgFontFaceId(vg, ctx->fontStash->regular);
     nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
     nvgBeginPath(vg);
     nvgText(vg, x + style->AppletFrame.separatorSpacing + style->AppletFrame.footerTextSpacing, y + height - style->AppletFrame.footerHeight / 2, Application::getTitle().c_str(), nullptr);
@@ -20,8 +20,7 @@
 #include <borealis/button.hpp>
 #include <borealis/dialog.hpp>
 #include <borealis/i18n.hpp>
-
-using namespace brls::i18n::literals;
+#include <borealis/nine_slice.hpp>
 
 // TODO: different open animation?
 
@@ -34,7 +33,11 @@ Dialog::Dialog(View* contentView)
     if (contentView)
         contentView->setParent(this);
 
-    this->registerAction("brls/hints/back"_i18n, Key::B, [this] { return this->onCancel(); });
+    static const ActionTable actions = {
+        memberAction(i18n::Translation("brls/hints/back"), Key::B, &Dialog::onCancel),
+    };
+
+    this->setActionTable(&actions);
 }
 
 Dialog::Dialog(std::string text)
@@ -93,19 +96,9 @@ void Dialog::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height,
     float shadowOpacity = style->Dialog.shadowOpacity;
     float shadowOffset  = style->Dialog.shadowOffset;
 
-    NVGpaint shadowPaint = nvgBoxGradient(vg,
-        this->frameX, this->frameY + shadowWidth,
-        this->frameWidth, this->frameHeight,
-        style->Dialog.cornerRadius * 2, shadowFeather,
-        RGBA(0, 0, 0, shadowOpacity * alpha), transparent);
-
-    nvgBeginPath(vg);
-    nvgRect(vg, this->frameX - shadowOffset, this->frameY - shadowOffset,
-        this->frameWidth + shadowOffset * 2, this->frameHeight + shadowOffset * 3);
-    nvgRoundedRect(vg, this->frameX, this->frameY, this->frameWidth, this->frameHeight, style->Dialog.cornerRadius);
-    nvgPathWinding(vg, NVG_HOLE);
-    nvgFillPaint(vg, shadowPaint);
-    nvgFill(vg);
+    Decorations::drawShadow(vg, this->frameX, this->frameY, this->frameWidth, this->frameHeight,
+        style->Dialog.cornerRadius, shadowWidth, shadowFeather, shadowOffset,
+        RGBA(0, 0, 0, shadowOpacity * alpha));
 
     // Frame
     nvgFillColor(vg, a(ctx->theme->dialogColor));
@@ -22,57 +22,173 @@
 #include <borealis/dropdown.hpp>
 #include <borealis/i18n.hpp>
 #include <borealis/logger.hpp>
+#include <cctype>
+#include <cmath>
 
-using namespace brls::i18n::literals;
-
-#define SELECT_VIEW_MAX_ITEMS 6 // for max height
-
-#define min(a, b) ((a < b) ? a : b)
+#define SELECT_VIEW_ITEMS_SPACING 2 // same as list items without description
+#define TYPE_AHEAD_TIMEOUT 1000000 // us, the typed text is reset after that
+#define DROPDOWN_POOL_SIZE 2 // closed dropdowns kept for reuse
 
 // TODO: Turns out the fade out animation is the same as the fade in (top -> bottom)
 
 namespace brls
 {
 
-Dropdown::Dropdown(std::string title, std::vector<std::string> values, ValueSelectedEvent::Callback cb, size_t selected)
-    : title(title)
+Dropdown::Dropdown()
 {
     Style* style = Application::getStyle();
 
-    this->valueEvent.subscribe(cb);
+    // List items are recycled as the list scrolls
+    for (size_t i = 0; i < SELECT_VIEW_ROWS; i++)
+    {
+        ListItem* row = new ListItem("");
+        row->setParent(this);
+        row->setHeight(style->Dropdown.listItemHeight);
+        row->setTextSize(style->Dropdown.listItemTextSize);
+
+        row->getClickEvent()->subscribe([this, i](View* view) {
+            this->valueEvent.fire((int)this->rowValues[i]);
+            Application::popView();
+        });
+
+        this->rows[i] = row;
+    }
+
+    this->hint = new Hint();
+    this->hint->setParent(this);
+
+    static const ActionTable actions = {
+        memberAction(i18n::Translation("brls/hints/back"), Key::B, &Dropdown::onCancel),
+        memberAction("", Key::L, &Dropdown::jumpToPreviousLetter, true),
+        memberAction("", Key::R, &Dropdown::jumpToNextLetter, true),
+    };
+
+    this->setActionTable(&actions);
+}
+
+void Dropdown::bind(std::string title, DropdownValues values, ValueSelectedEvent::Callback cb, size_t selected)
+{
+    Style* style = Application::getStyle();
+
+    this->title       = title;
+    this->values      = values;
+    this->valuesCount = values->size();
+    this->selected    = selected < this->valuesCount ? selected : this->valuesCount;
+
+    this->valueSubscription = this->valueEvent.subscribe(cb);
+
+    for (size_t i = 0; i < SELECT_VIEW_ROWS; i++)
+        this->rowValues[i] = this->valuesCount;
+
+    this->cursor  = this->selected < this->valuesCount ? this->selected : 0;
+    this->scrollY = this->getScrollTarget(this->cursor);
 
     this->topOffset = (float)style->Dropdown.listPadding / 8.0f;
 
-    this->valuesCount = values.size();
+    this->typeAheadText.clear();
+    this->typeAheadTime = 0;
+
+    this->invalidate();
+}
+
+bool Dropdown::recycle()
+{
+    if (Dropdown::pool.size() >= DROPDOWN_POOL_SIZE)
+        return false;
+
+    menu_animation_ctx_tag tag = (uintptr_t) & this->scrollY;
+    menu_animation_kill_by_tag(&tag);
+
+    // Release the values and callback captures until the next open
+    this->valueEvent.unsubscribe(this->valueSubscription);
+    this->values.reset();
+    this->valuesCount = 0;
 
-    this->list = new List(selected);
-    this->list->setParent(this);
-    this->list->setMargins(1, 0, 1, 0);
+    Dropdown::pool.push_back(this);
+    return true;
+}
 
-    for (size_t i = 0; i < values.size(); i++)
+void Dropdown::clearPool()
+{
+    for (Dropdown* dropdown : Dropdown::pool)
+        delete dropdown;
+
+    Dropdown::pool.clear();
+}
+
+ListItem* Dropdown::bindRow(size_t value)
+{
+    size_t index  = value % SELECT_VIEW_ROWS;
+    ListItem* row = this->rows[index];
+
+    if (this->rowValues[index] != value)
     {
-        std::string value = values[i];
+        this->rowValues[index] = value;
 
-        ListItem* item = new ListItem(value);
+        row->setLabel((*this->values)[value]);
+        row->setChecked(value == this->selected);
+        row->setDrawTopSeparator(value == 0);
+    }
 
-        if (i == selected)
-            item->setChecked(true);
+    return row;
+}
 
-        item->setHeight(style->Dropdown.listItemHeight);
-        item->setTextSize(style->Dropdown.listItemTextSize);
+unsigned Dropdown::getRowPitch(Style* style)
+{
+    return style->Dropdown.listItemHeight + SELECT_VIEW_ITEMS_SPACING;
+}
 
-        item->getClickEvent()->subscribe([this, i](View* view) {
-            this->valueEvent.fire(i);
-            Application::popView();
-        });
+float Dropdown::getScrollTarget(size_t value)
+{
+    Style* style = Application::getStyle();
 
-        this->list->addView(item);
+    float pitch         = (float)this->getRowPitch(style);
+    float viewHeight    = (float)(std::min((size_t)SELECT_VIEW_MAX_ITEMS, this->valuesCount) * style->Dropdown.listItemHeight);
+    float contentHeight = (float)this->valuesCount * pitch;
+
+    // Keep the value in the middle, like List does
+    float target = 1.0f + (float)value * pitch + (float)style->Dropdown.listItemHeight / 2.0f - viewHeight / 2.0f;
+
+    return std::max(std::min(target, contentHeight - viewHeight), 0.0f);
+}
+
+void Dropdown::scrollTo(float target, bool animated)
+{
+    menu_animation_ctx_tag tag = (uintptr_t) & this->scrollY;
+    menu_animation_kill_by_tag(&tag);
+
+    // Only animate short distances: further rows are not bound
+    Style* style = Application::getStyle();
+
+    if (animated && std::fabs(target - this->scrollY) <= this->getRowPitch(style) * 2)
+    {
+        menu_animation_ctx_entry_t entry;
+        entry.cb           = [](void* userdata) {};
+        entry.duration     = style->AnimationDuration.highlight;
+        entry.easing_enum  = EASING_OUT_QUAD;
+        entry.subject      = &this->scrollY;
+        entry.tag          = tag;
+        entry.target_value = target;
+        entry.tick         = [this](void* userdata) { this->invalidate(); };
+        entry.userdata     = nullptr;
+
+        menu_animation_push(&entry);
     }
+    else
+    {
+        this->scrollY = target;
+    }
+}
 
-    this->hint = new Hint();
-    this->hint->setParent(this);
+void Dropdown::jumpTo(size_t value)
+{
+    this->cursor = value;
+    this->scrollTo(this->getScrollTarget(value), false);
+
+    ListItem* row = this->bindRow(value);
+    this->invalidate(true); // place the row before giving it focus
 
-    this->registerAction("brls/hints/back"_i18n, Key::B, [this] { return this->onCancel(); });
+    Application::giveFocus(row);
 }
 
 void Dropdown::show(std::function<void(void)> cb, bool animate, ViewAnimation animation)
@@ -94,7 +210,7 @@ void Dropdown::show(std::function<void(void)> cb, bool animate, ViewAnimation an
 
 void Dropdown::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
 {
-    unsigned top = this->list->getY() - style->Dropdown.headerHeight - style->Dropdown.listPadding;
+    unsigned top = this->listY - style->Dropdown.headerHeight - style->Dropdown.listPadding;
 
     // Backdrop
     nvgFillColor(vg, a(ctx->theme->dropdownBackgroundColor));
@@ -111,7 +227,16 @@ void Dropdown::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned heigh
     nvgFill(vg);
 
     // List
-    this->list->frame(ctx);
+    nvgSave(vg);
+    nvgScissor(vg, this->listX, this->listY, this->listWidth, this->listHeight);
+
+    for (size_t i = 0; i < SELECT_VIEW_ROWS; i++)
+    {
+        if (this->rowValues[i] < this->valuesCount)
+            this->rows[i]->frame(ctx);
+    }
+
+    nvgRestore(vg);
 
     // Footer
     this->hint->frame(ctx);
@@ -124,6 +249,7 @@ void Dropdown::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned heigh
 
     nvgFillColor(vg, ctx->theme->textColor); // we purposely don't apply opacity
     nvgFontSize(vg, style->AppletFrame.footerTextSize);
+    nvgFontFaceId(vg, ctx->fontStash->regular);
     nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
     nvgBeginPath(vg);
     nvgText(vg, x + style->AppletFrame.separatorSpacing + style->AppletFrame.footerTextSpacing, y + height - style->AppletFrame.footerHeight / 2, Application::getCommonFooter()->c_str(), nullptr);
@@ -157,15 +283,37 @@ unsigned Dropdown::getShowAnimationDuration(ViewAnimation animation)
 void Dropdown::layout(NVGcontext* vg, Style* style, FontStash* stash)
 {
     // Layout and move the list
-    unsigned listHeight = min(SELECT_VIEW_MAX_ITEMS, this->valuesCount) * style->Dropdown.listItemHeight - (unsigned)this->topOffset;
-    unsigned listWidth  = style->Dropdown.listWidth + style->List.marginLeftRight * 2;
+    this->listHeight = std::min((size_t)SELECT_VIEW_MAX_ITEMS, this->valuesCount) * style->Dropdown.listItemHeight - (unsigned)this->topOffset;
+    this->listWidth  = style->Dropdown.listWidth + style->List.marginLeftRight * 2;
 
-    this->list->setBoundaries(
-        this->width / 2 - listWidth / 2,
-        this->height - style->AppletFrame.footerHeight - listHeight - style->Dropdown.listPadding + (unsigned)this->topOffset,
-        listWidth,
-        listHeight);
-    this->list->invalidate(true); // call layout directly to update scrolling
+    this->listX = this->width / 2 - this->listWidth / 2;
+    this->listY = this->height - style->AppletFrame.footerHeight - this->listHeight - style->Dropdown.listPadding + (unsigned)this->topOffset;
+
+    // Bind the visible values to rows, then the focused one in case it's not visible
+    if (this->valuesCount > 0)
+    {
+        unsigned pitch = this->getRowPitch(style);
+        size_t first   = (size_t)std::max((this->scrollY - 1.0f) / pitch, 0.0f);
+        size_t last    = std::min((size_t)((this->scrollY + this->listHeight) / pitch), this->valuesCount - 1);
+
+        for (size_t value = first; value <= last; value++)
+            this->bindRow(value);
+
+        this->bindRow(this->cursor);
+
+        for (size_t i = 0; i < SELECT_VIEW_ROWS; i++)
+        {
+            if (this->rowValues[i] >= this->valuesCount)
+                continue;
+
+            this->rows[i]->setBoundaries(
+                this->listX,
+                this->listY + 1 + (int)roundf(this->rowValues[i] * pitch - this->scrollY),
+                this->listWidth,
+                style->Dropdown.listItemHeight);
+            this->rows[i]->invalidate();
+        }
+    }
 
     // Hint
     // TODO: convert the bottom-left footer into a Label to get its width and avoid clipping with the hint
@@ -181,19 +329,192 @@ void Dropdown::layout(NVGcontext* vg, Style* style, FontStash* stash)
 
 View* Dropdown::getDefaultFocus()
 {
-    return this->list->getDefaultFocus();
+    if (this->valuesCount == 0)
+        return nullptr;
+
+    return this->bindRow(this->cursor);
+}
+
+View* Dropdown::getNextFocus(FocusDirection direction, View* currentView)
+{
+    if (direction == FocusDirection::UP && this->cursor > 0)
+        this->cursor--;
+    else if (direction == FocusDirection::DOWN && this->cursor + 1 < this->valuesCount)
+        this->cursor++;
+    else
+        return nullptr;
+
+    this->scrollTo(this->getScrollTarget(this->cursor), true);
+
+    ListItem* row = this->bindRow(this->cursor);
+    this->invalidate(true); // place the row before it gets focus
+
+    return row;
+}
+
+static bool startsWith(const std::string& value, const std::string& prefix)
+{
+    if (value.size() < prefix.size())
+        return false;
+
+    for (size_t i = 0; i < prefix.size(); i++)
+    {
+        if (std::tolower((unsigned char)value[i]) != std::tolower((unsigned char)prefix[i]))
+            return false;
+    }
+
+    return true;
+}
+
+// Returns true if the string is only made of the given character, repeated
+static bool isRepeated(const std::string& string, const std::string& character)
+{
+    if (string.size() % character.size() != 0)
+        return false;
+
+    for (size_t i = 0; i < string.size(); i++)
+    {
+        if (std::tolower((unsigned char)string[i]) != std::tolower((unsigned char)character[i % character.size()]))
+            return false;
+    }
+
+    return true;
+}
+
+static void appendCodepoint(std::string& string, unsigned int codepoint)
+{
+    if (codepoint < 0x80)
+    {
+        string += (char)codepoint;
+    }
+    else if (codepoint < 0x800)
+    {
+        string += (char)(0xC0 | (codepoint >> 6));
+        string += (char)(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint < 0x10000)
+    {
+        string += (char)(0xE0 | (codepoint >> 12));
+        string += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        string += (char)(0x80 | (codepoint & 0x3F));
+    }
+    else
+    {
+        string += (char)(0xF0 | (codepoint >> 18));
+        string += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        string += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        string += (char)(0x80 | (codepoint & 0x3F));
+    }
+}
+
+bool Dropdown::acceptsCharInput()
+{
+    return true;
+}
+
+bool Dropdown::onCharInput(unsigned int codepoint)
+{
+    if (this->valuesCount == 0)
+        return true;
+
+    retro_time_t now = cpu_features_get_time_usec();
+
+    if (now - this->typeAheadTime > TYPE_AHEAD_TIMEOUT)
+        this->typeAheadText.clear();
+
+    this->typeAheadTime = now;
+
+    std::string character;
+    appendCodepoint(character, codepoint);
+    this->typeAheadText += character;
+
+    // Typing a new first letter goes to the next value starting with it,
+    // and typing the same letter again cycles through them
+    bool cycle                = isRepeated(this->typeAheadText, character);
+    const std::string& prefix = cycle ? character : this->typeAheadText;
+    size_t start              = cycle ? this->cursor + 1 : this->cursor;
+
+    for (size_t i = 0; i < this->valuesCount; i++)
+    {
+        size_t value = (start + i) % this->valuesCount;
+
+        if (startsWith((*this->values)[value], prefix))
+        {
+            this->jumpTo(value);
+            break;
+        }
+    }
+
+    return true;
+}
+
+static int getLetter(const std::string& value)
+{
+    return value.empty() ? -1 : std::tolower((unsigned char)value[0]);
+}
+
+bool Dropdown::jumpToPreviousLetter()
+{
+    if (this->cursor == 0)
+        return true;
+
+    // Go to the first value of the current letter, or of the previous one if already there
+    size_t value = this->cursor;
+    int letter   = getLetter((*this->values)[value - 1]);
+
+    while (value > 0 && getLetter((*this->values)[value - 1]) == letter)
+        value--;
+
+    this->jumpTo(value);
+    return true;
+}
+
+bool Dropdown::jumpToNextLetter()
+{
+    if (this->valuesCount == 0)
+        return true;
+
+    int letter = getLetter((*this->values)[this->cursor]);
+
+    for (size_t value = this->cursor + 1; value < this->valuesCount; value++)
+    {
+        if (getLetter((*this->values)[value]) != letter)
+        {
+            this->jumpTo(value);
+            break;
+        }
+    }
+
+    return true;
 }
 
 void Dropdown::open(std::string title, std::vector<std::string> values, ValueSelectedEvent::Callback cb, int selected)
 {
-    Dropdown* dropdown = new Dropdown(title, values, cb, selected);
+    Dropdown::open(title, std::make_shared<const std::vector<std::string>>(std::move(values)), cb, selected);
+}
+
+void Dropdown::open(std::string title, DropdownValues values, ValueSelectedEvent::Callback cb, int selected)
+{
+    Dropdown* dropdown = nullptr;
+
+    if (Dropdown::pool.empty())
+    {
+        dropdown = new Dropdown();
+    }
+    else
+    {
+        dropdown = Dropdown::pool.back();
+        Dropdown::pool.pop_back();
+    }
+
+    dropdown->bind(title, values, cb, selected < 0 ? values->size() : (size_t)selected);
     Application::pushView(dropdown);
 }
 
 void Dropdown::willAppear(bool resetState)
 {
-    if (this->list)
-        this->list->willAppear(resetState);
+    for (ListItem* row : this->rows)
+        row->willAppear(resetState);
 
     if (this->hint)
         this->hint->willAppear(resetState);
@@ -201,8 +522,8 @@ void Dropdown::willAppear(bool resetState)
 
 void Dropdown::willDisappear(bool resetState)
 {
-    if (this->list)
-        this->list->willDisappear(resetState);
+    for (ListItem* row : this->rows)
+        row->willDisappear(resetState);
 
     if (this->hint)
         this->hint->willDisappear(resetState);
@@ -210,7 +531,12 @@ void Dropdown::willDisappear(bool resetState)
 
 Dropdown::~Dropdown()
 {
-    delete this->list;
+    menu_animation_ctx_tag tag = (uintptr_t) & this->scrollY;
+    menu_animation_kill_by_tag(&tag);
+
+    for (ListItem* row : this->rows)
+        delete row;
+
     delete this->hint;
 }
 
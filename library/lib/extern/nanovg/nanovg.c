@@ -42,7 +42,7 @@
 #define NVG_INIT_POINTS_SIZE 128
 #define NVG_INIT_PATHS_SIZE 16
 #define NVG_INIT_VERTS_SIZE 256
-#define NVG_MAX_STATES 32
+#define NVG_INIT_STATES 32
 
 #define NVG_KAPPA90 0.5522847493f	// Length proportional to radius of a cubic bezier handle for 90deg arcs.
 
@@ -115,8 +115,9 @@ struct NVGcontext {
 	int ccommands;
 	int ncommands;
 	float commandx, commandy;
-	NVGstate states[NVG_MAX_STATES];
+	NVGstate* states;
 	int nstates;
+	int cstates;
 	NVGpathCache* cache;
 	float tessTol;
 	float distTol;
@@ -303,6 +304,11 @@ NVGcontext* nvgCreateInternal(NVGparams* params)
 	ctx->cache = nvg__allocPathCache();
 	if (ctx->cache == NULL) goto error;
 
+	ctx->states = (NVGstate*)malloc(sizeof(NVGstate)*NVG_INIT_STATES);
+	if (!ctx->states) goto error;
+	ctx->nstates = 0;
+	ctx->cstates = NVG_INIT_STATES;
+
 	nvgSave(ctx);
 	nvgReset(ctx);
 
@@ -346,6 +352,7 @@ void nvgDeleteInternal(NVGcontext* ctx)
 	if (ctx == NULL) return;
 	if (ctx->commands != NULL) free(ctx->commands);
 	if (ctx->cache != NULL) nvg__deletePathCache(ctx->cache);
+	if (ctx->states != NULL) free(ctx->states);
 
 	if (ctx->fs)
 		fonsDeleteInternal(ctx->fs);
@@ -624,8 +631,13 @@ static void nvg__setPaintColor(NVGpaint* p, NVGcolor color)
 // State handling
 void nvgSave(NVGcontext* ctx)
 {
-	if (ctx->nstates >= NVG_MAX_STATES)
-		return;
+	if (ctx->nstates >= ctx->cstates) {
+		int cstates = ctx->cstates * 2;
+		NVGstate* states = (NVGstate*)realloc(ctx->states, sizeof(NVGstate)*cstates);
+		if (states == NULL) return;
+		ctx->states = states;
+		ctx->cstates = cstates;
+	}
 	if (ctx->nstates > 0)
 		memcpy(&ctx->states[ctx->nstates], &ctx->states[ctx->nstates-1], sizeof(NVGstate));
 	ctx->nstates++;
@@ -21,7 +21,9 @@
 #include <borealis/application.hpp>
 #include <borealis/hint.hpp>
 #include <borealis/label.hpp>
-#include <set>
+
+#define HINT_MAX_ACTIONS 32 // at most one per key
+#define HINT_LABELS_CACHE_SIZE 8
 
 namespace brls
 {
@@ -36,101 +38,168 @@ Hint::Hint(bool animate)
     this->setHeight(style->AppletFrame.footerHeight);
     this->setSpacing(style->AppletFrame.footerTextSpacing);
 
-    // Subscribe to all events
+    // Subscribe to all events, the hints are rebuilt on next frame
     this->globalFocusEventSubscriptor = Application::getGlobalFocusChangeEvent()->subscribe([this](View* newFocus) {
-        this->rebuildHints();
+        this->rebuildRequested = true;
     });
 
     this->globalHintsUpdateEventSubscriptor = Application::getGlobalHintsUpdateEvent()->subscribe([this]() {
-        this->rebuildHints();
+        this->rebuildRequested = true;
+    });
+
+    this->localeChangeEventSubscriptor = i18n::getLocaleChangeEvent()->subscribe([this]() {
+        this->rebuildRequested = true;
     });
 }
 
-bool actionsSortFunc(Action a, Action b)
+// From left to right:
+//  - first +
+//  - then all hints that are not B and A
+//  - finally B and A
+static unsigned getActionRank(const Action* action)
 {
-    // From left to right:
-    //  - first +
-    //  - then all hints that are not B and A
-    //  - finally B and A
-
-    // + is before all others
-    if (a.key == Key::PLUS)
-        return true;
-
-    // A is after all others
-    if (b.key == Key::A)
-        return true;
+    switch (action->key)
+    {
+        case Key::PLUS:
+            return 0;
+        case Key::B:
+            return 2;
+        case Key::A:
+            return 3;
+        default:
+            return 1;
+    }
+}
 
-    // B is after all others but A
-    if (b.key == Key::B && a.key != Key::A)
-        return true;
+void Hint::frame(FrameContext* ctx)
+{
+    if (this->rebuildRequested)
+    {
+        this->rebuildRequested = false;
+        this->rebuildHints();
+    }
 
-    // Keep original order for the rest
-    return false;
+    BoxLayout::frame(ctx);
 }
 
 void Hint::rebuildHints()
 {
-    // Check if the focused element is still a child of the same parent as the hint view's
+    // Iterate over the view tree to find all the actions to display
+    // We only ever want one action per key
+    const Action* actions[HINT_MAX_ACTIONS];
+    size_t actionsCount = 0;
+    uint32_t addedKeys  = 0;
+
+    View* focusParent = nullptr;
+
+    for (View* view = Application::getCurrentFocus(); view != nullptr; view = view->getParent())
     {
-        View* focusParent    = Application::getCurrentFocus();
-        View* hintBaseParent = this;
+        focusParent = view;
 
-        while (focusParent != nullptr)
-        {
-            if (focusParent->getParent() == nullptr)
-                break;
-            focusParent = focusParent->getParent();
-        }
+        view->forEachAction([&](const Action& action) {
+            if (action.hidden || (addedKeys & getKeyMask(action.key)))
+                return;
+
+            addedKeys |= getKeyMask(action.key);
+            actions[actionsCount++] = &action;
+        });
+    }
 
-        while (hintBaseParent != nullptr)
+    if (focusParent)
+    {
+        for (const Action& action : Application::getGlobalActions()->getActions())
         {
-            if (hintBaseParent->getParent() == nullptr)
-                break;
-            hintBaseParent = hintBaseParent->getParent();
-        }
+            if (action.hidden || (addedKeys & getKeyMask(action.key)))
+                continue;
 
-        if (focusParent != hintBaseParent)
-            return;
+            addedKeys |= getKeyMask(action.key);
+            actions[actionsCount++] = &action;
+        }
     }
 
-    // Empty the layout and re-populate it with new Labels
-    this->clear(true);
+    // Check if the focused element is still a child of the same parent as the hint view's
+    View* hintBaseParent = this;
 
-    std::set<Key> addedKeys; // we only ever want one action per key
-    View* focusParent = Application::getCurrentFocus();
+    while (hintBaseParent->getParent() != nullptr)
+        hintBaseParent = hintBaseParent->getParent();
 
-    // Iterate over the view tree to find all the actions to display
-    std::vector<Action> actions;
+    if (focusParent != hintBaseParent)
+        return;
+
+    // Sort the actions
+    const Action* sortedActions[HINT_MAX_ACTIONS];
+    size_t sortedCount = 0;
 
-    while (focusParent != nullptr)
+    for (unsigned rank = 0; rank <= 3; rank++)
     {
-        for (auto& action : focusParent->getActions())
+        for (size_t i = 0; i < actionsCount; i++)
         {
-            if (action.hidden)
-                continue;
+            if (getActionRank(actions[i]) == rank)
+                sortedActions[sortedCount++] = actions[i];
+        }
+    }
 
-            if (addedKeys.find(action.key) != addedKeys.end())
-                continue;
+    // Don't touch the layout if the hints didn't change
+    std::string texts[HINT_MAX_ACTIONS];
+    bool changed = sortedCount != this->hintLabels.size();
 
-            addedKeys.insert(action.key);
-            actions.push_back(action);
-        }
+    for (size_t i = 0; i < sortedCount; i++)
+    {
+        texts[i] = sortedActions[i]->getHintText();
 
-        focusParent = focusParent->getParent();
+        if (!changed && (this->hintLabels[i].key != sortedActions[i]->key || this->hintLabels[i].text != texts[i]))
+            changed = true;
     }
 
-    // Sort the actions
-    std::stable_sort(actions.begin(), actions.end(), actionsSortFunc);
+    if (!changed)
+        return;
+
+    // Detach the labels and keep them for later
+    this->clear(false);
+
+    for (HintLabel& hintLabel : this->hintLabels)
+    {
+        free(hintLabel.label->getParentUserData());
+        hintLabel.label->setParent(nullptr);
+
+        this->unusedHintLabels.push_back(std::move(hintLabel));
+    }
+
+    this->hintLabels.clear();
 
-    // Populate the layout with labels
-    for (Action action : actions)
+    // Populate the layout with labels, reusing them if possible
+    for (size_t i = 0; i < sortedCount; i++)
     {
-        std::string hintText = Hint::getKeyIcon(action.key) + "  " + action.hintText;
+        Key key      = sortedActions[i]->key;
+        Label* label = this->takeHintLabel(key, texts[i]);
 
-        Label* label = new Label(LabelStyle::HINT, hintText);
+        this->hintLabels.push_back({ key, texts[i], label });
         this->addView(label);
     }
+
+    // Only keep the most recent unused labels
+    while (this->unusedHintLabels.size() > HINT_LABELS_CACHE_SIZE)
+    {
+        delete this->unusedHintLabels.front().label;
+        this->unusedHintLabels.erase(this->unusedHintLabels.begin());
+    }
+}
+
+Label* Hint::takeHintLabel(Key key, const std::string& text)
+{
+    for (size_t i = this->unusedHintLabels.size(); i > 0; i--)
+    {
+        HintLabel& hintLabel = this->unusedHintLabels[i - 1];
+
+        if (hintLabel.key == key && hintLabel.text == text)
+        {
+            Label* label = hintLabel.label;
+            this->unusedHintLabels.erase(this->unusedHintLabels.begin() + (i - 1));
+            return label;
+        }
+    }
+
+    return new Label(LabelStyle::HINT, Hint::getKeyIcon(key) + "  " + text);
 }
 
 Hint::~Hint()
@@ -138,6 +207,11 @@ Hint::~Hint()
     // Unregister all events
     Application::getGlobalFocusChangeEvent()->unsubscribe(this->globalFocusEventSubscriptor);
     Application::getGlobalHintsUpdateEvent()->unsubscribe(this->globalHintsUpdateEventSubscriptor);
+    i18n::getLocaleChangeEvent()->unsubscribe(this->localeChangeEventSubscriptor);
+
+    // Displayed labels are freed by the layout
+    for (HintLabel& hintLabel : this->unusedHintLabels)
+        delete hintLabel.label;
 }
 
 std::string Hint::getKeyIcon(Key key)
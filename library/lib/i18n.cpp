@@ -16,23 +16,225 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <string.h>
+
+#include <algorithm>
 #include <borealis.hpp>
+#include <charconv>
+#include <deque>
+#include <fmt/format.h>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <iterator>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #ifdef __SWITCH__
 #include <switch.h>
 #endif
 
+// Compiled catalogs are read in memory on platforms without mmap
+#if !defined(__SWITCH__) && !defined(_WIN32)
+#define CATALOG_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #define DEFAULT_LOCALE "en-US"
 
+#define CATALOG_MAGIC "BRLS"
+#define CATALOG_VERSION 1
+
 namespace brls::i18n
 {
 
-static nlohmann::json defaultLocale = {};
-static nlohmann::json currentLocale = {};
+struct StringHash
+{
+    size_t operator()(uint64_t hash) const
+    {
+        return (size_t)hash; // already a FNV-1a hash
+    }
+};
+
+// Binary catalogs, as compiled by scripts/i18n-compiler.py
+// See the script for a description of the format
+struct CatalogHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t poolSize;
+};
+
+struct CatalogEntry
+{
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t length;
+};
+
+static_assert(sizeof(CatalogHeader) == 16 && sizeof(CatalogEntry) == 16, "Catalog structures must not be padded");
+
+// A translated format string, parsed and validated once at load time
+// Literal text is copied as is when formatting, and each replacement
+// field is formatted directly from its argument and its parsed spec
+struct FormatSegment
+{
+    bool argument;
+    std::string text; // literal text, or the raw spec of the argument (for user-defined types)
+
+    int index = 0;
+    fmt::format_specs specs = fmt::format_specs();
+};
+
+// Parses the format spec of a replacement field at load time, nested
+// replacement fields (dynamic width and precision) are rejected beforehand
+class FormatSpecsParser : public fmt::detail::specs_setter<char>
+{
+  public:
+    explicit FormatSpecsParser(fmt::format_specs& specs)
+        : fmt::detail::specs_setter<char>(specs)
+    {
+    }
+
+    template <typename Id>
+    void on_dynamic_width(Id)
+    {
+        this->on_error("nested replacement fields are not supported");
+    }
+
+    template <typename Id>
+    void on_dynamic_precision(Id)
+    {
+        this->on_error("nested replacement fields are not supported");
+    }
+
+    void on_error(const char* message)
+    {
+        throw fmt::format_error(message);
+    }
+};
+
+struct CompiledFormat
+{
+    std::vector<FormatSegment> segments;
+    bool valid         = true;
+    bool errorReported = false; // for errors that depend on the arguments
+};
+
+struct TranslatedString
+{
+    std::string_view string;
+    CompiledFormat* format = nullptr; // nullptr if the string has no replacement field
+};
+
+// The strings of one namespace of one locale, loaded from its catalog or JSON file
+// Owns the memory of its strings, can be loaded from any thread
+// Strings are looked up with a binary search: catalogs are used in
+// place since their index is already sorted by hash
+struct NamespaceFile
+{
+    std::deque<std::string> pool; // JSON strings or catalog read in memory
+    std::string_view mapping; // mapped catalog
+    std::deque<CompiledFormat> formats;
+
+    // JSON files: strings sorted by hash
+    std::vector<std::pair<uint64_t, TranslatedString>> strings;
+
+    // Catalogs: index and strings pool, and formats of the strings having one by index
+    const CatalogEntry* entries = nullptr;
+    uint32_t entriesCount       = 0;
+    const char* entriesPool     = nullptr;
+    std::vector<std::pair<uint32_t, CompiledFormat*>> entriesFormats;
+
+#ifndef NDEBUG
+    std::vector<std::pair<uint64_t, std::string>> names; // full string names, JSON files only
+#endif
+
+    NamespaceFile() = default;
+    NamespaceFile(const NamespaceFile&) = delete;
+
+    ~NamespaceFile()
+    {
+#ifdef CATALOG_MMAP
+        if (!this->mapping.empty())
+            munmap((void*)this->mapping.data(), this->mapping.size());
+#endif
+    }
+
+    bool find(uint64_t hash, TranslatedString* string) const
+    {
+        if (!this->entries)
+        {
+            auto it = std::lower_bound(this->strings.begin(), this->strings.end(), hash, [](const auto& entry, uint64_t hash) { return entry.first < hash; });
+
+            if (it == this->strings.end() || it->first != hash)
+                return false;
+
+            *string = it->second;
+            return true;
+        }
+
+        const CatalogEntry* end   = this->entries + this->entriesCount;
+        const CatalogEntry* entry = std::lower_bound(this->entries, end, hash, [](const CatalogEntry& entry, uint64_t hash) { return entry.hash < hash; });
+
+        if (entry == end || entry->hash != hash)
+            return false;
+
+        uint32_t index = entry - this->entries;
+        auto format    = std::lower_bound(this->entriesFormats.begin(), this->entriesFormats.end(), index, [](const auto& format, uint32_t index) { return format.first < index; });
+
+        string->string = std::string_view(this->entriesPool + entry->offset, entry->length);
+        string->format = format != this->entriesFormats.end() && format->first == index ? format->second : nullptr;
+        return true;
+    }
+};
+
+typedef std::vector<std::unique_ptr<NamespaceFile>> NamespaceFiles;
+
+// A namespace of strings ("brls", "main"...), loaded the
+// first time one of its strings is requested
+struct Namespace
+{
+    std::string name;
+    bool loaded = false;
+    std::future<NamespaceFiles> preloaded; // valid if preloading in the background
+    std::vector<NamespaceFile*> files; // owned by loadedFiles, current locale last
+};
+
+// Default locale first, then current locale (if different)
+static std::vector<std::string> locales;
+
+// All known namespaces, by hash of their name
+static std::unordered_map<uint64_t, Namespace, StringHash> namespaces;
+
+// Translations already looked up, so that a string is only searched once
+// Keys are hashes of full string names ("brls/hints/ok"), current locale strings
+// override default locale ones
+// Values are views into loadedFiles
+static std::unordered_map<uint64_t, TranslatedString, StringHash> translations;
+static NamespaceFiles loadedFiles;
+
+#ifndef NDEBUG
+// Full string names of all loaded hashes, to detect collisions
+static std::unordered_map<uint64_t, std::string> stringNames;
+#endif
+
+static bool backgroundPreloadEnabled = false;
+static bool firstFrameDisplayed      = false;
+static std::future<void> preloadTask;
+
+// Locale set with setLocale(), empty to use the system one
+static std::string forcedLocale;
+
+static Event<> localeChangeEvent;
 
 static bool endsWith(const std::string& str, const std::string& suffix)
 {
@@ -40,51 +242,378 @@ static bool endsWith(const std::string& str, const std::string& suffix)
     return str.size() >= suffix.size() && 0 == str.compare(str.size() - suffix.size(), suffix.size(), suffix);
 }
 
-static void loadLocale(std::string locale, nlohmann::json* target)
+static std::string localePath(const std::string& locale)
 {
-    std::string localePath = BOREALIS_ASSET("i18n/" + locale); // TODO: use a platform agnostic separator if someone cares about Windows
+    return BOREALIS_ASSET("i18n/" + locale); // TODO: use a platform agnostic separator if someone cares about Windows
+}
 
-    if (!std::filesystem::exists(localePath))
+static void flattenStrings(const nlohmann::json& node, std::string& path, const std::string& file, NamespaceFile* target)
+{
+    if (node.is_object())
     {
-        brls::Logger::error("Cannot load locale {}: directory {} doesn't exist", locale, localePath);
-        return;
+        size_t pathLength = path.length();
+
+        for (auto& [key, value] : node.items())
+        {
+            path += "/" + key;
+            flattenStrings(value, path, file, target);
+            path.resize(pathLength);
+        }
     }
-    else if (!std::filesystem::is_directory(localePath))
+    else if (node.is_string())
     {
-        brls::Logger::error("Cannot load locale {}: {} isn't a directory", locale, localePath);
-        return;
+        std::string_view string = target->pool.emplace_back(node.get<std::string>());
+        uint64_t hash           = internal::hashStr(path.data(), path.length());
+
+        target->strings.push_back({ hash, { string } });
+
+#ifndef NDEBUG
+        target->names.push_back({ hash, path });
+#endif
     }
+    else
+    {
+        BRLS_LOG_ERROR("Error while loading \"{}\": string \"{}\" is not a string", file, path);
+    }
+}
 
-    // Iterate over all JSON files in the directory
-    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(localePath))
+static std::string_view mapFile(const std::string& path, NamespaceFile* target)
+{
+#ifdef CATALOG_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+
+    if (fd == -1)
+        return {};
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
     {
-        if (entry.is_directory())
+        close(fd);
+        return {};
+    }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return {};
+
+    target->mapping = std::string_view((const char*)data, st.st_size);
+    return target->mapping;
+#else
+    std::ifstream stream(path, std::ios::binary);
+    return target->pool.emplace_back(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+#endif
+}
+
+static bool loadCatalog(const std::string& path, NamespaceFile* target)
+{
+    std::string_view file = mapFile(path, target);
+
+    if (file.size() < sizeof(CatalogHeader))
+    {
+        BRLS_LOG_ERROR("Error while loading \"{}\": cannot read catalog", path);
+        return false;
+    }
+
+    const CatalogHeader* header = (const CatalogHeader*)file.data();
+
+    if (memcmp(header->magic, CATALOG_MAGIC, sizeof(header->magic)) != 0 || header->version != CATALOG_VERSION)
+    {
+        BRLS_LOG_ERROR("Error while loading \"{}\": unknown catalog format", path);
+        return false;
+    }
+
+    if (file.size() != sizeof(CatalogHeader) + header->count * sizeof(CatalogEntry) + header->poolSize)
+    {
+        BRLS_LOG_ERROR("Error while loading \"{}\": truncated catalog", path);
+        return false;
+    }
+
+    const CatalogEntry* entries = (const CatalogEntry*)(file.data() + sizeof(CatalogHeader));
+
+    for (uint32_t i = 0; i < header->count; i++)
+    {
+        const CatalogEntry& entry = entries[i];
+
+        if ((uint64_t)entry.offset + entry.length > header->poolSize)
+        {
+            BRLS_LOG_ERROR("Error while loading \"{}\": string out of bounds", path);
+            return false;
+        }
+
+        if (i > 0 && entries[i - 1].hash >= entry.hash)
+        {
+            BRLS_LOG_ERROR("Error while loading \"{}\": index is not sorted", path);
+            return false;
+        }
+    }
+
+    // The index is used in place
+    target->entries      = entries;
+    target->entriesCount = header->count;
+    target->entriesPool  = (const char*)(entries + header->count);
+
+    return true;
+}
+
+static void loadJson(const std::string& path, std::string stringPath, NamespaceFile* target)
+{
+    nlohmann::json strings;
+
+    std::ifstream jsonStream;
+    jsonStream.open(path);
+
+    try
+    {
+        jsonStream >> strings;
+        flattenStrings(strings, stringPath, path, target);
+
+        std::sort(target->strings.begin(), target->strings.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+    catch (const std::exception& e)
+    {
+        BRLS_LOG_ERROR("Error while loading \"{}\": {}", path, e.what());
+    }
+
+    jsonStream.close();
+}
+
+static bool compileFormat(std::string_view string, CompiledFormat* format, std::string* error)
+{
+    std::string text;
+    int nextArgument  = 0;
+    bool autoIndexing = false, manualIndexing = false;
+
+    for (size_t i = 0; i < string.length(); i++)
+    {
+        char c = string[i];
+
+        // Escaped braces
+        if ((c == '{' || c == '}') && i + 1 < string.length() && string[i + 1] == c)
+        {
+            text += c;
+            i++;
             continue;
+        }
 
-        std::string name = entry.path().filename().string();
+        if (c == '}')
+        {
+            *error = "unmatched '}'";
+            return false;
+        }
 
-        if (!endsWith(name, ".json"))
+        if (c != '{')
+        {
+            text += c;
             continue;
+        }
 
-        std::string path = entry.path().string();
+        // Replacement field
+        size_t end = string.find_first_of("{}", i + 1);
 
-        nlohmann::json strings;
+        if (end == std::string_view::npos || string[end] != '}')
+        {
+            *error = end == std::string_view::npos ? "unmatched '{'" : "nested replacement fields are not supported";
+            return false;
+        }
+
+        std::string_view field = string.substr(i + 1, end - i - 1);
+        std::string_view id    = field.substr(0, field.find(':'));
+        std::string_view spec  = id.length() < field.length() ? field.substr(id.length()) : "";
 
-        std::ifstream jsonStream;
-        jsonStream.open(path);
+        int argument;
+
+        if (id.empty())
+        {
+            argument     = nextArgument++;
+            autoIndexing = true;
+        }
+        else if (id.find_first_not_of("0123456789") == std::string_view::npos)
+        {
+            if (std::from_chars(id.data(), id.data() + id.length(), argument).ec != std::errc())
+            {
+                *error = "argument index is too large";
+                return false;
+            }
+
+            manualIndexing = true;
+        }
+        else
+        {
+            *error = "named arguments are not supported";
+            return false;
+        }
+
+        if (autoIndexing && manualIndexing)
+        {
+            *error = "cannot mix automatic and manual argument indexing";
+            return false;
+        }
+
+        FormatSegment segment = { true, spec.empty() ? "" : std::string(spec.substr(1)), argument };
 
         try
         {
-            jsonStream >> strings;
+            const char* specEnd = segment.text.data() + segment.text.length();
+
+            if (fmt::detail::parse_format_specs(segment.text.data(), specEnd, FormatSpecsParser(segment.specs)) != specEnd)
+                throw fmt::format_error("invalid format specifier");
         }
-        catch (const std::exception& e)
+        catch (const fmt::format_error& e)
         {
-            brls::Logger::error("Error while loading \"{}\": {}", path, e.what());
+            *error = e.what();
+            return false;
         }
 
-        jsonStream.close();
+        if (!text.empty())
+            format->segments.push_back({ false, std::move(text) });
+
+        format->segments.push_back(std::move(segment));
 
-        (*target)[name.substr(0, name.length() - 5)] = strings;
+        text.clear();
+        i = end;
+    }
+
+    if (!text.empty())
+        format->segments.push_back({ false, std::move(text) });
+
+    return true;
+}
+
+static CompiledFormat* compileStringFormat(std::string_view string, NamespaceFile* file, const std::string& path)
+{
+    if (string.find_first_of("{}") == std::string_view::npos)
+        return nullptr;
+
+    CompiledFormat* format = &file->formats.emplace_back();
+
+    std::string error;
+    if (!compileFormat(string, format, &error))
+    {
+        BRLS_LOG_ERROR("Invalid format \"{}\" in \"{}\": {}", string, path, error);
+        format->valid = false;
+    }
+
+    return format;
+}
+
+static void compileFormats(NamespaceFile* file, const std::string& path)
+{
+    for (auto& [hash, string] : file->strings)
+        string.format = compileStringFormat(string.string, file, path);
+
+    for (uint32_t i = 0; i < file->entriesCount; i++)
+    {
+        const CatalogEntry& entry = file->entries[i];
+
+        if (CompiledFormat* format = compileStringFormat(std::string_view(file->entriesPool + entry.offset, entry.length), file, path))
+            file->entriesFormats.push_back({ i, format });
+    }
+}
+
+static std::unique_ptr<NamespaceFile> loadNamespaceFile(const std::string& locale, const std::string& name)
+{
+    std::string jsonPath    = localePath(locale) + "/" + name + ".json";
+    std::string catalogPath = localePath(locale) + "/" + name + ".bin";
+
+    std::error_code jsonError, catalogError;
+    std::filesystem::file_time_type jsonTime    = std::filesystem::last_write_time(jsonPath, jsonError);
+    std::filesystem::file_time_type catalogTime = std::filesystem::last_write_time(catalogPath, catalogError);
+
+    // Prefer the catalog unless the JSON file is more recent
+    if (!catalogError)
+    {
+        if (!jsonError && jsonTime > catalogTime)
+        {
+            BRLS_LOG_WARNING("Catalog \"{}\" is outdated, loading \"{}\" instead", catalogPath, jsonPath);
+        }
+        else
+        {
+            std::unique_ptr<NamespaceFile> file = std::make_unique<NamespaceFile>();
+
+            if (loadCatalog(catalogPath, file.get()))
+            {
+                compileFormats(file.get(), catalogPath);
+                return file;
+            }
+        }
+    }
+
+    if (jsonError)
+        return nullptr;
+
+    std::unique_ptr<NamespaceFile> file = std::make_unique<NamespaceFile>();
+    loadJson(jsonPath, name, file.get());
+    compileFormats(file.get(), jsonPath);
+    return file;
+}
+
+static NamespaceFiles loadNamespaceFiles(const std::vector<std::string>& locales, const std::string& name)
+{
+    NamespaceFiles files;
+
+    for (const std::string& locale : locales)
+    {
+        if (std::unique_ptr<NamespaceFile> file = loadNamespaceFile(locale, name))
+            files.push_back(std::move(file));
+    }
+
+    return files;
+}
+
+static void loadNamespace(Namespace* ns)
+{
+    NamespaceFiles files = ns->preloaded.valid() ? ns->preloaded.get() : loadNamespaceFiles(locales, ns->name);
+
+    for (std::unique_ptr<NamespaceFile>& file : files)
+    {
+#ifndef NDEBUG
+        for (const auto& [hash, name] : file->names)
+        {
+            if (auto [it, inserted] = stringNames.emplace(hash, name); !inserted && it->second != name)
+                BRLS_LOG_ERROR("Error while loading namespace {}: string \"{}\" has the same hash as \"{}\"", ns->name, name, it->second);
+        }
+#endif
+
+        ns->files.push_back(file.get());
+        loadedFiles.push_back(std::move(file));
+    }
+
+    ns->loaded = true;
+}
+
+static void discoverNamespaces(const std::string& locale)
+{
+    std::string path = localePath(locale);
+
+    if (!std::filesystem::exists(path))
+    {
+        BRLS_LOG_ERROR("Cannot load locale {}: directory {} doesn't exist", locale, path);
+        return;
+    }
+    else if (!std::filesystem::is_directory(path))
+    {
+        BRLS_LOG_ERROR("Cannot load locale {}: {} isn't a directory", locale, path);
+        return;
+    }
+
+    // Every JSON file or compiled catalog is a namespace
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(path))
+    {
+        if (entry.is_directory())
+            continue;
+
+        std::string name = entry.path().filename().string();
+
+        if (endsWith(name, ".json"))
+            name = name.substr(0, name.length() - 5);
+        else if (endsWith(name, ".bin"))
+            name = name.substr(0, name.length() - 4);
+        else
+            continue;
+
+        namespaces[internal::hashStr(name.data(), name.length())].name = name;
     }
 }
 
@@ -102,67 +631,225 @@ std::string getCurrentLocale()
     }
     else
     {
-        brls::Logger::error("Unable to get system language (error 0x{0:x}), using the default one: {1}", res, DEFAULT_LOCALE);
+        BRLS_LOG_ERROR("Unable to get system language (error 0x{0:x}), using the default one: {1}", res, DEFAULT_LOCALE);
     }
 #endif
     return DEFAULT_LOCALE;
 }
 
-void loadTranslations()
+void loadTranslations(bool backgroundPreload)
 {
-    loadLocale(DEFAULT_LOCALE, &defaultLocale);
+    // Wait for the previous preloading, if any
+    if (preloadTask.valid())
+        preloadTask.wait();
+
+    namespaces.clear();
+    translations.clear();
+    loadedFiles.clear();
 
-    std::string currentLocaleName = getCurrentLocale();
+#ifndef NDEBUG
+    stringNames.clear();
+#endif
+
+    // Current locale is last to override the default strings
+    locales = { DEFAULT_LOCALE };
+
+    std::string currentLocaleName = getLocale();
     if (currentLocaleName != DEFAULT_LOCALE)
-        loadLocale(currentLocaleName, &currentLocale);
+        locales.push_back(currentLocaleName);
+
+    for (const std::string& locale : locales)
+        discoverNamespaces(locale);
+
+    backgroundPreloadEnabled = backgroundPreload;
+}
+
+void setLocale(std::string locale)
+{
+    BRLS_LOG_INFO("Switching locale to {}", locale.empty() ? getCurrentLocale() : locale);
+
+    forcedLocale = locale;
+    loadTranslations(backgroundPreloadEnabled);
+
+    // Relabel bound views, loading the namespaces they need
+    localeChangeEvent.fire();
+
+    // Preload the others if the app is already running
+    if (backgroundPreloadEnabled && firstFrameDisplayed)
+        preloadTranslations();
+}
+
+std::string getLocale()
+{
+    if (!forcedLocale.empty())
+        return forcedLocale;
+
+    return getCurrentLocale();
+}
+
+Event<>* getLocaleChangeEvent()
+{
+    return &localeChangeEvent;
+}
+
+TranslationBinding::~TranslationBinding()
+{
+    this->unbind();
+}
+
+void TranslationBinding::bind(Translation translation, Callback callback)
+{
+    this->unbind();
+
+    callback(translation.str());
+
+    this->subscription = localeChangeEvent.subscribe([translation, callback]() {
+        callback(translation.str());
+    });
+    this->bound = true;
+}
+
+void TranslationBinding::unbind()
+{
+    if (!this->bound)
+        return;
+
+    localeChangeEvent.unsubscribe(this->subscription);
+    this->bound = false;
+}
+
+bool TranslationBinding::isBound()
+{
+    return this->bound;
+}
+
+void preloadTranslations()
+{
+    std::vector<std::pair<std::string, std::promise<NamespaceFiles>>> toLoad;
+
+    for (auto& [hash, ns] : namespaces)
+    {
+        if (ns.loaded || ns.preloaded.valid())
+            continue;
+
+        std::promise<NamespaceFiles> promise;
+        ns.preloaded = promise.get_future();
+        toLoad.emplace_back(ns.name, std::move(promise));
+    }
+
+    if (toLoad.empty())
+        return;
+
+    BRLS_LOG_DEBUG("Preloading {} i18n namespaces in the background", toLoad.size());
+
+    // Only load the files in the background, they will be merged in the
+    // translations table by the UI thread when first requested
+    preloadTask = std::async(std::launch::async, [locales = locales, toLoad = std::move(toLoad)]() mutable {
+        for (auto& [name, promise] : toLoad)
+            promise.set_value(loadNamespaceFiles(locales, name));
+    });
+}
+
+static const TranslatedString* findStr(uint64_t hash, std::string_view stringName)
+{
+    if (auto it = translations.find(hash); it != translations.end())
+        return &it->second;
+
+    // Search the files of the string namespace, loading it if it isn't already
+    std::string_view namespaceName = stringName.substr(0, stringName.find('/'));
+    auto ns                        = namespaces.find(internal::hashStr(namespaceName.data(), namespaceName.size()));
+
+    if (ns == namespaces.end())
+        return nullptr;
+
+    if (!ns->second.loaded)
+        loadNamespace(&ns->second);
+
+    // Current locale first
+    for (auto file = ns->second.files.rbegin(); file != ns->second.files.rend(); file++)
+    {
+        TranslatedString string;
+
+        if ((*file)->find(hash, &string))
+            return &translations.emplace(hash, string).first->second;
+    }
+
+    return nullptr;
 }
 
 namespace internal
 {
-    std::string getRawStr(std::string stringName)
+    std::string_view getRawStr(uint64_t hash, std::string_view stringName)
     {
-        nlohmann::json::json_pointer pointer;
+        if (const TranslatedString* string = findStr(hash, stringName))
+            return string->string;
 
-        try
-        {
-            pointer = nlohmann::json::json_pointer("/" + stringName);
-        }
-        catch (const std::exception& e)
-        {
-            brls::Logger::error("Error while getting string \"{}\": {}", stringName, e.what());
-            return stringName;
-        }
+        // Fallback to returning the string name
+        return stringName;
+    }
 
-        // First look for translated string in current locale
-        try
-        {
-            return currentLocale[pointer].get<std::string>();
-        }
-        catch (...)
-        {
-        }
+    std::string formatStr(uint64_t hash, std::string_view stringName, fmt::format_args args)
+    {
+        const TranslatedString* string = findStr(hash, stringName);
+
+        if (!string)
+            return std::string(stringName);
+
+        if (!string->format)
+            return std::string(string->string);
+
+        // Invalid formats are reported at load time
+        CompiledFormat* format = string->format;
+
+        if (!format->valid)
+            return std::string(stringName);
+
+        thread_local fmt::memory_buffer buffer;
+        buffer.clear();
 
-        // Then look for default locale
         try
         {
-            return defaultLocale[pointer].get<std::string>();
+            fmt::format_context context(fmt::format_context::iterator(buffer), args);
+
+            for (const FormatSegment& segment : format->segments)
+            {
+                if (!segment.argument)
+                {
+                    buffer.append(segment.text.data(), segment.text.data() + segment.text.length());
+                    continue;
+                }
+
+                fmt::format_context::format_arg arg = args.get(segment.index);
+
+                if (!arg)
+                    throw fmt::format_error("argument not found");
+
+                // The spec is only parsed again by formatters of user-defined types
+                fmt::format_parse_context parseContext(segment.text);
+                fmt::format_specs specs = segment.specs;
+
+                fmt::visit_format_arg(fmt::detail::arg_formatter<fmt::format_context::iterator, char>(context, &parseContext, &specs), arg);
+            }
         }
-        catch (...)
+        catch (const std::exception& e)
         {
+            if (!format->errorReported)
+                BRLS_LOG_ERROR("Invalid format \"{}\" from string \"{}\": {}", string->string, stringName, e.what());
+
+            format->errorReported = true;
+            return std::string(stringName);
         }
 
-        // Fallback to returning the string name
-        return stringName;
+        return fmt::to_string(buffer);
     }
-} // namespace internal
 
-inline namespace literals
-{
-    std::string operator"" _i18n(const char* str, size_t len)
+    void onFirstFrame()
     {
-        return brls::i18n::internal::getRawStr(std::string(str, len));
-    }
+        firstFrameDisplayed = true;
 
-} // namespace literals
+        if (backgroundPreloadEnabled)
+            preloadTranslations();
+    }
+} // namespace internal
 
 } // namespace brls::i18n
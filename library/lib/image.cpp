@@ -97,8 +97,6 @@ Image::~Image()
 
 void Image::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
 {
-    nvgSave(vg);
-
     if (this->texture != -1)
     {
         nvgBeginPath(vg);
@@ -106,8 +104,6 @@ void Image::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height,
         nvgFillPaint(vg, a(this->imgPaint));
         nvgFill(vg);
     }
-
-    nvgRestore(vg);
 }
 
 void Image::reloadTexture()
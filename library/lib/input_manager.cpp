@@ -0,0 +1,533 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <borealis/application.hpp>
+#include <borealis/input_manager.hpp>
+#include <cmath>
+#include <sstream>
+
+// Repeat timings, in microseconds
+#define BUTTON_REPEAT_DELAY 250000 // between the press and the first repeat
+#define BUTTON_REPEAT_INTERVAL 83000 // between two repeats
+#define BUTTON_REPEAT_MAX_LAG 250000 // late repeats after a long frame are dropped past that
+
+// Left stick navigation
+#define STICK_REPEAT_DELAY 250000 // us, between the deflection and the first repeat
+#define STICK_MIN_RATE 4.0f // steps per second, barely deflected
+#define STICK_BASE_RATE 15.0f // steps per second, fully deflected
+#define STICK_ACCELERATION 3.0f // rate increase per second spent deflected, relative to the base rate
+#define STICK_MAX_RATE 500.0f // steps per second
+
+#define REPLAY_FRAME_TIME 16667 // us, virtual clock step
+
+namespace brls
+{
+
+// Keyboard -> gamepad mapping
+static const struct
+{
+    int key;
+    int button;
+} keyboardMapping[] = {
+    { GLFW_KEY_LEFT, GLFW_GAMEPAD_BUTTON_DPAD_LEFT },
+    { GLFW_KEY_RIGHT, GLFW_GAMEPAD_BUTTON_DPAD_RIGHT },
+    { GLFW_KEY_UP, GLFW_GAMEPAD_BUTTON_DPAD_UP },
+    { GLFW_KEY_DOWN, GLFW_GAMEPAD_BUTTON_DPAD_DOWN },
+    { GLFW_KEY_ESCAPE, GLFW_GAMEPAD_BUTTON_START },
+    { GLFW_KEY_F1, GLFW_GAMEPAD_BUTTON_BACK },
+    { GLFW_KEY_ENTER, GLFW_GAMEPAD_BUTTON_A },
+    { GLFW_KEY_BACKSPACE, GLFW_GAMEPAD_BUTTON_B },
+    { GLFW_KEY_L, GLFW_GAMEPAD_BUTTON_LEFT_BUMPER },
+    { GLFW_KEY_R, GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER },
+};
+
+// Button names of the replay format
+static const struct
+{
+    const char* name;
+    int button;
+} buttonNames[] = {
+    { "A", GLFW_GAMEPAD_BUTTON_A },
+    { "B", GLFW_GAMEPAD_BUTTON_B },
+    { "X", GLFW_GAMEPAD_BUTTON_X },
+    { "Y", GLFW_GAMEPAD_BUTTON_Y },
+    { "L", GLFW_GAMEPAD_BUTTON_LEFT_BUMPER },
+    { "R", GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER },
+    { "MINUS", GLFW_GAMEPAD_BUTTON_BACK },
+    { "PLUS", GLFW_GAMEPAD_BUTTON_START },
+    { "GUIDE", GLFW_GAMEPAD_BUTTON_GUIDE },
+    { "LSTICK", GLFW_GAMEPAD_BUTTON_LEFT_THUMB },
+    { "RSTICK", GLFW_GAMEPAD_BUTTON_RIGHT_THUMB },
+    { "DUP", GLFW_GAMEPAD_BUTTON_DPAD_UP },
+    { "DRIGHT", GLFW_GAMEPAD_BUTTON_DPAD_RIGHT },
+    { "DDOWN", GLFW_GAMEPAD_BUTTON_DPAD_DOWN },
+    { "DLEFT", GLFW_GAMEPAD_BUTTON_DPAD_LEFT },
+};
+
+static int getButton(const std::string& name)
+{
+    for (auto& buttonName : buttonNames)
+    {
+        if (name == buttonName.name)
+            return buttonName.button;
+    }
+
+    return -1;
+}
+
+static const char* getButtonName(int button)
+{
+    for (auto& buttonName : buttonNames)
+    {
+        if (button == buttonName.button)
+            return buttonName.name;
+    }
+
+    return "?";
+}
+
+void InputManager::onKeyboardKey(int key, int action, retro_time_t time)
+{
+    if (action == GLFW_REPEAT || this->replaying) // repeats are handled by update()
+        return;
+
+    for (auto& mapping : keyboardMapping)
+    {
+        if (mapping.key != key)
+            continue;
+
+        uint32_t newButtons = this->keyboardButtons;
+
+        if (action == GLFW_PRESS)
+            newButtons |= 1u << mapping.button;
+        else
+            newButtons &= ~(1u << mapping.button);
+
+        this->setButtons(this->keyboardButtons, newButtons, this->gamepadButtons, time);
+        this->keyboardButtons = newButtons;
+        return;
+    }
+}
+
+void InputManager::onCharInput(unsigned int codepoint, retro_time_t time)
+{
+    if (this->replaying)
+        return;
+
+    this->events.push_back({ time, -1, false, codepoint });
+
+    if (this->recordFile.is_open())
+        this->record(time, fmt::format("char {}", codepoint));
+}
+
+void InputManager::pollGamepad(retro_time_t time)
+{
+    if (this->replaying)
+        return;
+
+    GLFWgamepadstate state;
+    uint32_t newButtons = 0;
+
+    if (glfwGetGamepadState(GLFW_JOYSTICK_1, &state))
+    {
+        for (int i = GLFW_GAMEPAD_BUTTON_A; i <= GLFW_GAMEPAD_BUTTON_LAST; i++)
+        {
+            if (state.buttons[i] == GLFW_PRESS)
+                newButtons |= 1u << i;
+        }
+    }
+    else
+    {
+        state = {};
+    }
+
+    this->pollStick(state.axes[GLFW_GAMEPAD_AXIS_LEFT_X], state.axes[GLFW_GAMEPAD_AXIS_LEFT_Y], time);
+
+    this->setButtons(this->gamepadButtons, newButtons, this->keyboardButtons, time);
+    this->gamepadButtons = newButtons;
+}
+
+void InputManager::setStickDeadzone(float deadzone)
+{
+    this->stickDeadzone = std::min(std::max(deadzone, 0.0f), 0.95f);
+}
+
+void InputManager::pollStick(float x, float y, retro_time_t time)
+{
+    // Record two decimals, enough for the deflection
+    if (this->recordFile.is_open() && (std::round(x * 100) != std::round(this->recordedStickX * 100) || std::round(y * 100) != std::round(this->recordedStickY * 100)))
+    {
+        this->recordedStickX = x;
+        this->recordedStickY = y;
+        this->record(time, fmt::format("stick {:.2f} {:.2f}", x, y));
+    }
+
+    // Only keep the dominant axis
+    float value = std::fabs(x) > std::fabs(y) ? x : y;
+    int button  = -1;
+
+    if (std::fabs(value) > this->stickDeadzone)
+    {
+        if (std::fabs(x) > std::fabs(y))
+            button = x < 0.0f ? GLFW_GAMEPAD_BUTTON_DPAD_LEFT : GLFW_GAMEPAD_BUTTON_DPAD_RIGHT;
+        else
+            button = y < 0.0f ? GLFW_GAMEPAD_BUTTON_DPAD_UP : GLFW_GAMEPAD_BUTTON_DPAD_DOWN;
+    }
+
+    this->stick.deflection = button == -1 ? 0.0f : std::min((std::fabs(value) - this->stickDeadzone) / (1.0f - this->stickDeadzone), 1.0f);
+
+    if (button == this->stick.button)
+        return;
+
+    // New direction: press now, repeat later
+    this->stick.button = button;
+
+    if (button != -1)
+    {
+        this->stick.pressButton  = button;
+        this->stick.pressPending = true;
+        this->stick.pressTime    = time;
+        this->stick.steps        = 0.0f;
+    }
+}
+
+void InputManager::updateStick(retro_time_t now)
+{
+    StickState& stick = this->stick;
+
+    if (stick.pressPending)
+    {
+        stick.pressPending = false;
+        stick.lastUpdate   = stick.pressTime + STICK_REPEAT_DELAY;
+
+        // Dispatch the press even if the stick is already back to the center
+        Application::onGamepadButtonPressed(stick.pressButton, false);
+    }
+
+    if (stick.button == -1 || now <= stick.lastUpdate)
+        return;
+
+    // Accumulate steps since the last update
+    float elapsed = std::min(now - stick.lastUpdate, (retro_time_t)BUTTON_REPEAT_MAX_LAG) / 1000000.0f;
+    float held    = (now - stick.pressTime - STICK_REPEAT_DELAY) / 1000000.0f;
+
+    float rate = STICK_MIN_RATE + (STICK_BASE_RATE - STICK_MIN_RATE) * stick.deflection;
+    rate       = std::min(rate * (1.0f + STICK_ACCELERATION * held), STICK_MAX_RATE);
+
+    stick.steps += rate * elapsed;
+    stick.lastUpdate = now;
+
+    if (stick.steps < 1.0f)
+        return;
+
+    // Send all whole steps at once: focus only moves once per frame
+    unsigned steps = (unsigned)stick.steps;
+    stick.steps -= steps;
+
+    Application::onGamepadButtonPressed(stick.button, true, steps);
+}
+
+void InputManager::setButtons(uint32_t oldButtons, uint32_t newButtons, uint32_t otherButtons, retro_time_t time)
+{
+    // A button is pressed as long as any source presses it
+    uint32_t changed = (oldButtons ^ newButtons) & ~otherButtons;
+
+    for (int i = GLFW_GAMEPAD_BUTTON_A; changed != 0; i++)
+    {
+        uint32_t mask = 1u << i;
+
+        if (!(changed & mask))
+            continue;
+
+        this->events.push_back({ time, i, (newButtons & mask) != 0 });
+
+        if (this->recordFile.is_open())
+            this->record(time, fmt::format("{} {}", (newButtons & mask) ? "press" : "release", getButtonName(i)));
+
+        changed &= ~mask;
+    }
+}
+
+void InputManager::update(retro_time_t now)
+{
+    if (this->replaying)
+        now = this->updateReplay(now);
+
+    // Queued events, indexed since dispatching them can queue more
+    for (size_t i = 0; i < this->events.size(); i++)
+    {
+        InputEvent event = this->events[i];
+
+        if (event.button == -1)
+        {
+            Application::onCharInput(event.codepoint);
+            continue;
+        }
+
+        ButtonState& state = this->buttons[event.button];
+
+        state.pressed = event.pressed;
+
+        if (event.pressed)
+        {
+            state.nextRepeat = event.time + BUTTON_REPEAT_DELAY;
+            Application::onGamepadButtonPressed(event.button, false);
+        }
+    }
+
+    this->events.clear();
+
+    // Repeats
+    for (int i = GLFW_GAMEPAD_BUTTON_A; i <= GLFW_GAMEPAD_BUTTON_LAST; i++)
+    {
+        ButtonState& state = this->buttons[i];
+
+        if (!state.pressed)
+            continue;
+
+        if (now - state.nextRepeat > BUTTON_REPEAT_MAX_LAG)
+            state.nextRepeat = now;
+
+        while (now >= state.nextRepeat)
+        {
+            state.nextRepeat += BUTTON_REPEAT_INTERVAL;
+            Application::onGamepadButtonPressed(i, true);
+        }
+    }
+
+    this->updateStick(now);
+}
+
+void InputManager::record(retro_time_t time, std::string command)
+{
+    this->recordFile << fmt::format("{:.3f} {}\n", (time - this->recordStart) / 1000.0, command);
+}
+
+bool InputManager::startRecording(std::string path)
+{
+    this->stopRecording();
+
+    this->recordFile.open(path);
+
+    if (!this->recordFile.is_open())
+    {
+        BRLS_LOG_ERROR("Cannot open input recording file \"{}\"", path);
+        return false;
+    }
+
+    this->recordStart    = cpu_features_get_time_usec();
+    this->recordedStickX = 0.0f;
+    this->recordedStickY = 0.0f;
+
+    this->recordFile << "# borealis input recording, see InputManager::startReplay\n";
+
+    BRLS_LOG_INFO("Recording inputs to \"{}\"", path);
+    return true;
+}
+
+void InputManager::stopRecording()
+{
+    if (this->recordFile.is_open())
+        this->recordFile.close();
+}
+
+bool InputManager::startReplay(std::string path, bool virtualClock)
+{
+    std::ifstream file(path);
+
+    if (!file.is_open())
+    {
+        BRLS_LOG_ERROR("Cannot open input replay file \"{}\"", path);
+        return false;
+    }
+
+    std::vector<ReplayEntry> entries;
+    std::string line;
+    unsigned lineNumber = 0;
+
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+
+        std::istringstream stream(line);
+        double time;
+        std::string command;
+
+        if (!(stream >> time)) // empty line or comment
+        {
+            if (line.find_first_not_of(" \t\r") == std::string::npos || line[line.find_first_not_of(" \t\r")] == '#')
+                continue;
+
+            BRLS_LOG_ERROR("Invalid input replay file \"{}\": line {} has no time", path, lineNumber);
+            return false;
+        }
+
+        ReplayEntry entry = { (retro_time_t)(time * 1000.0), ReplayCommand::QUIT, -1, 0.0f, 0.0f, 0 };
+        stream >> command;
+
+        if (command == "press" || command == "release")
+        {
+            std::string name;
+            stream >> name;
+
+            entry.command = command == "press" ? ReplayCommand::PRESS : ReplayCommand::RELEASE;
+            entry.button  = getButton(name);
+
+            if (entry.button == -1)
+            {
+                BRLS_LOG_ERROR("Invalid input replay file \"{}\": unknown button \"{}\" line {}", path, name, lineNumber);
+                return false;
+            }
+        }
+        else if (command == "stick")
+        {
+            entry.command = ReplayCommand::STICK;
+
+            if (!(stream >> entry.x >> entry.y))
+            {
+                BRLS_LOG_ERROR("Invalid input replay file \"{}\": invalid stick position line {}", path, lineNumber);
+                return false;
+            }
+        }
+        else if (command == "char")
+        {
+            entry.command = ReplayCommand::CHAR;
+
+            if (!(stream >> entry.codepoint) || entry.codepoint > 0x10FFFF)
+            {
+                BRLS_LOG_ERROR("Invalid input replay file \"{}\": invalid character line {}", path, lineNumber);
+                return false;
+            }
+        }
+        else if (command != "quit")
+        {
+            BRLS_LOG_ERROR("Invalid input replay file \"{}\": unknown command \"{}\" line {}", path, command, lineNumber);
+            return false;
+        }
+
+        entries.push_back(entry);
+    }
+
+    // Allow hand written files to be out of order
+    std::stable_sort(entries.begin(), entries.end(), [](const ReplayEntry& a, const ReplayEntry& b) { return a.time < b.time; });
+
+    this->stopReplay();
+
+    // Release everything from the real inputs
+    this->setButtons(this->keyboardButtons | this->gamepadButtons, 0, 0, cpu_features_get_time_usec());
+    this->keyboardButtons = this->gamepadButtons = 0;
+    this->pollStick(0.0f, 0.0f, cpu_features_get_time_usec());
+
+    this->replayEntries      = std::move(entries);
+    this->replayPosition     = 0;
+    this->replaying          = true;
+    this->replayVirtualClock = virtualClock;
+    this->replayStart        = -1;
+    this->replayFrames       = 0;
+    this->replayWorstFrame   = 0;
+
+    BRLS_LOG_INFO("Replaying {} inputs from \"{}\"", this->replayEntries.size(), path);
+    return true;
+}
+
+void InputManager::stopReplay()
+{
+    if (!this->replaying)
+        return;
+
+    this->replaying = false;
+
+    retro_time_t time = this->replayVirtualClock ? this->replayTime : cpu_features_get_time_usec();
+    this->setButtons(this->replayButtons, 0, 0, time);
+    this->replayButtons = 0;
+    this->pollStick(0.0f, 0.0f, time);
+
+    // Frame times
+    if (this->replayFrames > 1)
+    {
+        double duration = (this->replayRealTime - this->replayStart) / 1000.0;
+        BRLS_LOG_INFO("Input replay done: {} frames in {:.0f}ms, {:.2f}ms per frame on average, worst frame {:.2f}ms",
+            this->replayFrames, duration, duration / (this->replayFrames - 1), this->replayWorstFrame / 1000.0);
+    }
+}
+
+bool InputManager::isReplaying()
+{
+    return this->replaying;
+}
+
+retro_time_t InputManager::updateReplay(retro_time_t now)
+{
+    if (this->replayStart == -1)
+        this->replayStart = this->replayTime = this->replayRealTime = now;
+
+    // Frame times
+    this->replayWorstFrame = std::max(this->replayWorstFrame, now - this->replayRealTime);
+    this->replayRealTime   = now;
+    this->replayFrames++;
+
+    retro_time_t time = this->replayVirtualClock ? this->replayTime : now;
+
+    if (this->replayVirtualClock)
+        this->replayTime += REPLAY_FRAME_TIME;
+
+    // Feed the inputs that are due
+    while (this->replayPosition < this->replayEntries.size() && this->replayEntries[this->replayPosition].time <= time - this->replayStart)
+    {
+        ReplayEntry& entry     = this->replayEntries[this->replayPosition++];
+        retro_time_t entryTime = this->replayStart + entry.time;
+        uint32_t newButtons    = this->replayButtons;
+
+        switch (entry.command)
+        {
+            case ReplayCommand::PRESS:
+                newButtons |= 1u << entry.button;
+                break;
+            case ReplayCommand::RELEASE:
+                newButtons &= ~(1u << entry.button);
+                break;
+            case ReplayCommand::STICK:
+                this->pollStick(entry.x, entry.y, entryTime);
+                break;
+            case ReplayCommand::CHAR:
+                this->events.push_back({ entryTime, -1, false, entry.codepoint });
+                break;
+            case ReplayCommand::QUIT:
+                Application::quit();
+                break;
+        }
+
+        this->setButtons(this->replayButtons, newButtons, 0, entryTime);
+        this->replayButtons = newButtons;
+    }
+
+    // Buttons still pressed are released after the last inputs are dispatched
+    if (this->replayPosition == this->replayEntries.size())
+        this->stopReplay();
+
+    return time;
+}
+
+InputManager::~InputManager()
+{
+    this->stopReplay();
+    this->stopRecording();
+}
+
+} // namespace brls
@@ -71,19 +71,28 @@ Label::Label(LabelStyle labelStyle, std::string text, bool multiline)
     }
 }
 
+Label::Label(LabelStyle labelStyle, i18n::Translation text, bool multiline)
+    : Label(labelStyle, "", multiline)
+{
+    this->setText(text);
+}
+
 void Label::setHorizontalAlign(NVGalign align)
 {
     this->horizontalAlign = align;
+    this->invalidateDrawing();
 }
 
 void Label::setVerticalAlign(NVGalign align)
 {
     this->verticalAlign = align;
+    this->invalidateDrawing();
 }
 
 void Label::setFontSize(unsigned size)
 {
-    this->fontSize = size;
+    this->fontSize     = size;
+    this->textMeasured = false;
 
     if (this->getParent())
         this->getParent()->invalidate();
@@ -91,7 +100,30 @@ void Label::setFontSize(unsigned size)
 
 void Label::setText(std::string text)
 {
-    this->text = text;
+    this->textBinding.unbind();
+    this->textObservableBinding.unbind();
+    this->updateText(text);
+}
+
+void Label::setText(i18n::Translation text)
+{
+    this->textObservableBinding.unbind();
+    this->textBinding.bind(text, [this](std::string text) { this->updateText(text); });
+}
+
+void Label::setText(Observable<std::string>* text)
+{
+    this->textBinding.unbind();
+    this->textObservableBinding.bind(text, [this](const std::string& text) {
+        if (text != this->text)
+            this->updateText(text);
+    });
+}
+
+void Label::updateText(std::string text)
+{
+    this->text         = text;
+    this->textMeasured = false;
 
     if (this->hasParent())
         this->getParent()->invalidate();
@@ -100,6 +132,7 @@ void Label::setText(std::string text)
 void Label::setStyle(LabelStyle style)
 {
     this->labelStyle = style;
+    this->invalidateDrawing();
 }
 
 void Label::layout(NVGcontext* vg, Style* style, FontStash* stash)
@@ -123,10 +156,16 @@ void Label::layout(NVGcontext* vg, Style* style, FontStash* stash)
     }
     else
     {
-        nvgTextBounds(vg, this->x, this->y, this->text.c_str(), nullptr, bounds);
+        if (!this->textMeasured)
+        {
+            nvgTextBounds(vg, this->x, this->y, this->text.c_str(), nullptr, bounds);
+
+            this->textWidth    = bounds[2] - bounds[0]; // xmax - xmin
+            this->textMeasured = true;
+        }
 
         unsigned oldWidth = this->width;
-        this->width       = bounds[2] - bounds[0]; // xmax - xmin
+        this->width       = this->textWidth;
 
         // offset the position to compensate the width change
         // and keep right alignment
@@ -177,11 +216,13 @@ void Label::setColor(NVGcolor color)
 {
     this->customColor    = color;
     this->useCustomColor = true;
+    this->invalidateDrawing();
 }
 
 void Label::unsetColor()
 {
     this->useCustomColor = false;
+    this->invalidateDrawing();
 }
 
 NVGcolor Label::getColor(Theme* theme)
@@ -217,11 +258,14 @@ void Label::setFont(int font)
 {
     this->customFont    = font;
     this->useCustomFont = true;
+    this->textMeasured  = false;
+    this->invalidateDrawing();
 }
 
 void Label::unsetFont()
 {
     this->useCustomFont = false;
+    this->textMeasured  = false;
 }
 
 int Label::getFont(FontStash* stash)
@@ -29,8 +29,6 @@
 #include <borealis/swkbd.hpp>
 #include <borealis/table.hpp>
 
-using namespace brls::i18n::literals;
-
 namespace brls
 {
 
@@ -123,7 +121,11 @@ ListItem::ListItem(std::string label, std::string description, std::string subLa
         this->descriptionView->setParent(this);
     }
 
-    this->registerAction("brls/hints/ok"_i18n, Key::A, [this] { return this->onClick(); });
+    static const ActionTable actions = {
+        memberAction(i18n::Translation("brls/hints/ok"), Key::A, &ListItem::onClick),
+    };
+
+    this->setActionTable(&actions);
 }
 
 void ListItem::setThumbnail(Image* image)
@@ -175,6 +177,7 @@ void ListItem::setReduceDescriptionSpacing(bool value)
 void ListItem::setIndented(bool indented)
 {
     this->indented = indented;
+    this->invalidateDrawing();
 }
 
 void ListItem::setTextSize(unsigned textSize)
@@ -185,6 +188,7 @@ void ListItem::setTextSize(unsigned textSize)
 void ListItem::setChecked(bool checked)
 {
     this->checked = checked;
+    this->invalidateDrawing();
 }
 
 bool ListItem::onClick()
@@ -248,7 +252,32 @@ void ListItem::resetValueAnimation()
     menu_animation_kill_by_tag(&tag);
 }
 
+void ListItem::setValue(i18n::Translation value, bool faint, bool animate)
+{
+    this->setValue(value.str(), faint, animate);
+
+    // Locale changes are not animated
+    this->valueBinding.bind(value, [this](std::string value) { this->value = value; });
+}
+
 void ListItem::setValue(std::string value, bool faint, bool animate)
+{
+    this->valueBinding.unbind();
+    this->valueObservableBinding.unbind();
+
+    this->updateValue(value, faint, animate);
+}
+
+void ListItem::setValue(Observable<std::string>* value, bool faint, bool animate)
+{
+    this->valueBinding.unbind();
+    this->valueObservableBinding.bind(value, [this, faint, animate](const std::string& value) {
+        if (value != this->value || faint != this->valueFaint)
+            this->updateValue(value, faint, animate);
+    });
+}
+
+void ListItem::updateValue(std::string value, bool faint, bool animate)
 {
     this->oldValue      = this->value;
     this->oldValueFaint = this->valueFaint;
@@ -257,6 +286,7 @@ void ListItem::setValue(std::string value, bool faint, bool animate)
     this->valueFaint = faint;
 
     this->resetValueAnimation();
+    this->invalidateDrawing();
 
     if (animate && this->oldValue != "")
     {
@@ -271,7 +301,7 @@ void ListItem::setValue(std::string value, bool faint, bool animate)
         entry.subject      = &this->valueAnimation;
         entry.tag          = tag;
         entry.target_value = 1.0f;
-        entry.tick         = [](void* userdata) {};
+        entry.tick         = [this](void* userdata) { this->invalidateDrawing(); };
         entry.userdata     = nullptr;
 
         menu_animation_push(&entry);
@@ -286,6 +316,7 @@ std::string ListItem::getValue()
 void ListItem::setDrawTopSeparator(bool draw)
 {
     this->drawTopSeparator = draw;
+    this->invalidateDrawing();
 }
 
 View* ListItem::getDefaultFocus()
@@ -446,9 +477,15 @@ std::string ListItem::getLabel()
 
 void ListItem::setLabel(std::string label)
 {
+    this->labelBinding.unbind();
     this->label = label;
 }
 
+void ListItem::setLabel(i18n::Translation label)
+{
+    this->labelBinding.bind(label, [this](std::string label) { this->label = label; });
+}
+
 ListItem::~ListItem()
 {
     if (this->descriptionView)
@@ -536,18 +573,23 @@ ListItemGroupSpacing::ListItemGroupSpacing(bool separator)
 }
 
 SelectListItem::SelectListItem(std::string label, std::vector<std::string> values, unsigned selectedValue, std::string description)
+    : SelectListItem(label, std::make_shared<const std::vector<std::string>>(std::move(values)), selectedValue, description)
+{
+}
+
+SelectListItem::SelectListItem(std::string label, DropdownValues values, unsigned selectedValue, std::string description)
     : ListItem(label, description)
     , values(values)
     , selectedValue(selectedValue)
 {
-    this->setValue(values[selectedValue], false, false);
+    this->setValue((*values)[selectedValue], false, false);
 
     this->getClickEvent()->subscribe([this](View* view) {
         ValueSelectedEvent::Callback valueCallback = [this](int result) {
             if (result == -1)
                 return;
 
-            this->setValue(this->values[result], false, false);
+            this->setValue((*this->values)[result], false, false);
             this->selectedValue = result;
 
             this->valueEvent.fire(result);
@@ -558,10 +600,10 @@ SelectListItem::SelectListItem(std::string label, std::vector<std::string> value
 
 void SelectListItem::setSelectedValue(unsigned value)
 {
-    if (value >= 0 && value < this->values.size())
+    if (value >= 0 && value < this->values->size())
     {
         this->selectedValue = value;
-        this->setValue(this->values[value], false, false);
+        this->setValue((*this->values)[value], false, false);
     }
 }
 
@@ -602,6 +644,11 @@ void List::clear(bool free)
     this->layout->clear(free);
 }
 
+void List::reconcile(const BoxLayoutBuilder& builder)
+{
+    this->layout->reconcile(builder);
+}
+
 size_t List::getViewsCount()
 {
     return this->layout->getViewsCount();
@@ -17,17 +17,677 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#include <fmt/core.h>
+#include <fmt/format.h>
+#include <signal.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 
+#include <algorithm>
+#include <atomic>
 #include <borealis/logger.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define LOG_QUEUE_SIZE 512 // must be a power of two
+#define LOG_MESSAGE_MAX_LENGTH 480
+#define LOG_WRITER_INTERVAL std::chrono::milliseconds(50)
+
+#define BINARY_LOG_MAGIC "BRLB"
+#define BINARY_LOG_VERSION 1
+#define BINARY_LOG_BUFFER_SIZE (64 * 1024) // per thread, must be a power of two
+
+// The crash handler needs write(2), which isn't available everywhere
+#if !defined(__SWITCH__) && !defined(_WIN32)
+#define LOG_CRASH_HANDLER
+#include <errno.h>
+#include <unistd.h>
+#endif
 
 namespace brls
 {
 
+struct LogRecord
+{
+    std::atomic<size_t> sequence;
+
+    LogLevel level;
+    std::chrono::system_clock::time_point time;
+
+    size_t length;
+    char message[LOG_MESSAGE_MAX_LENGTH];
+};
+
+// Bounded multi-producer ring buffer (see Dmitry Vyukov's MPMC queue)
+// A record is free for position p if its sequence is p, published if it's p + 1
+static LogRecord records[LOG_QUEUE_SIZE];
+static std::atomic<size_t> enqueuePos(0);
+
+// Consumer side, only touched with consumerLock held
+static std::atomic_flag consumerLock = ATOMIC_FLAG_INIT;
+static size_t dequeuePos           = 0;
+static size_t reportedDroppedCount = 0;
+
+static std::atomic<size_t> flushedPos(0);
+static std::atomic<size_t> droppedCount(0);
+
+static std::once_flag writerStarted;
+static std::thread writerThread;
+static std::atomic<bool> writerRunning(false);
+static std::atomic<bool> writerWakeUp(false);
+static std::mutex writerMutex;
+static std::condition_variable writerCondition; // wakes the writer up
+static std::condition_variable flushCondition; // wakes flush() callers up
+static bool writerDraining = false; // protected by writerMutex
+static size_t drainCount   = 0; // protected by writerMutex
+
+// Binary logging: every thread pushes its records to its own single producer
+// ring buffer, drained by the writer thread to the binary log file
+// Record: size (u32), format id (u32), time in ns (u64), args count (u8), args
+struct BinaryLogBuffer
+{
+    uint8_t data[BINARY_LOG_BUFFER_SIZE];
+
+    std::atomic<size_t> head = 0; // written by the thread
+    std::atomic<size_t> tail = 0; // written by the consumer
+
+    std::atomic<bool> orphaned = false; // the thread exited
+};
+
+struct BinaryLogBufferOwner
+{
+    BinaryLogBuffer* buffer = nullptr;
+
+    ~BinaryLogBufferOwner()
+    {
+        if (this->buffer)
+            this->buffer->orphaned = true;
+    }
+};
+
+static std::mutex binaryLogMutex; // for the lists below
+static std::vector<std::unique_ptr<BinaryLogBuffer>> binaryLogBuffers;
+static std::vector<const LogFormat*> binaryLogFormats; // by id
+
+static FILE* binaryLogFile           = nullptr;
+static size_t binaryLogFormatsWritten = 0;
+static uint8_t binaryLogRecord[BINARY_LOG_BUFFER_SIZE]; // consumer side
+
+static std::mutex logFileMutex;
+static FILE* logFile = nullptr;
+static std::atomic<int> logFileFd(-1); // descriptor of logFile, for the crash handler
+static std::string logFilePath;
+static size_t logFileSize    = 0;
+static size_t logFileMaxSize = 0;
+static unsigned logFileMaxFiles;
+
+static const char* getLevelPrefix(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::ERROR:
+            return "ERROR";
+        case LogLevel::WARNING:
+            return "WARNING";
+        case LogLevel::INFO:
+            return "INFO";
+        case LogLevel::DEBUG:
+        default:
+            return "DEBUG";
+    }
+}
+
+static const char* getLevelColor(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::ERROR:
+            return "[0;31m";
+        case LogLevel::WARNING:
+            return "[0;33m";
+        case LogLevel::INFO:
+            return "[0;34m";
+        case LogLevel::DEBUG:
+        default:
+            return "[0;32m";
+    }
+}
+
+static void rotateLogFile()
+{
+    fclose(logFile);
+
+    // path.(n-1) -> path.n ... path -> path.1
+    for (unsigned i = logFileMaxFiles; i > 0; i--)
+    {
+        std::string from = i == 1 ? logFilePath : fmt::format("{}.{}", logFilePath, i - 1);
+        std::string to   = fmt::format("{}.{}", logFilePath, i);
+
+        remove(to.c_str());
+        rename(from.c_str(), to.c_str());
+    }
+
+    logFile     = fopen(logFilePath.c_str(), "w");
+    logFileSize = 0;
+
+    logFileFd = logFile ? fileno(logFile) : -1;
+}
+
+static void writeMessage(LogLevel level, std::chrono::system_clock::time_point time, const char* message, size_t length)
+{
+    fprintf(stdout, "\033%s[%s]\033[0m %.*s\n", getLevelColor(level), getLevelPrefix(level), (int)length, message);
+
+    if (!logFile)
+        return;
+
+    time_t seconds = std::chrono::system_clock::to_time_t(time);
+    int millis     = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+
+    char timestamp[32];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&seconds));
+
+    int written = fprintf(logFile, "[%s.%03d] [%s] %.*s\n", timestamp, millis, getLevelPrefix(level), (int)length, message);
+
+    if (written > 0)
+        logFileSize += written;
+
+    if (logFileMaxSize > 0 && logFileSize >= logFileMaxSize)
+        rotateLogFile();
+}
+
+static void copyFromBinaryLogBuffer(BinaryLogBuffer* buffer, size_t pos, void* data, size_t size)
+{
+    size_t offset = pos & (BINARY_LOG_BUFFER_SIZE - 1);
+    size_t first  = std::min(size, (size_t)BINARY_LOG_BUFFER_SIZE - offset);
+
+    memcpy(data, buffer->data + offset, first);
+    memcpy((uint8_t*)data + first, buffer->data, size - first);
+}
+
+static void copyToBinaryLogBuffer(BinaryLogBuffer* buffer, size_t pos, const void* data, size_t size)
+{
+    size_t offset = pos & (BINARY_LOG_BUFFER_SIZE - 1);
+    size_t first  = std::min(size, (size_t)BINARY_LOG_BUFFER_SIZE - offset);
+
+    memcpy(buffer->data + offset, data, first);
+    memcpy(buffer->data, (const uint8_t*)data + first, size - first);
+}
+
+static void writeBinaryLogFormats()
+{
+    // Formats are registered before being used, so every record
+    // of a buffer has its format in the list
+    for (; binaryLogFormatsWritten < binaryLogFormats.size(); binaryLogFormatsWritten++)
+    {
+        const LogFormat* format = binaryLogFormats[binaryLogFormatsWritten];
+
+        uint32_t id         = format->id;
+        uint8_t level       = (uint8_t)format->level;
+        uint32_t line       = format->line;
+        uint16_t fileLength = strlen(format->file);
+        uint32_t length     = strlen(format->format);
+
+        fputc('F', binaryLogFile);
+        fwrite(&id, sizeof(id), 1, binaryLogFile);
+        fwrite(&level, sizeof(level), 1, binaryLogFile);
+        fwrite(&line, sizeof(line), 1, binaryLogFile);
+        fwrite(&fileLength, sizeof(fileLength), 1, binaryLogFile);
+        fwrite(format->file, 1, fileLength, binaryLogFile);
+        fwrite(&length, sizeof(length), 1, binaryLogFile);
+        fwrite(format->format, 1, length, binaryLogFile);
+    }
+}
+
+static void drainBinaryLogBuffers()
+{
+    std::lock_guard<std::mutex> lock(binaryLogMutex);
+
+    if (!binaryLogFile)
+        return;
+
+    writeBinaryLogFormats();
+
+    for (auto it = binaryLogBuffers.begin(); it != binaryLogBuffers.end();)
+    {
+        BinaryLogBuffer* buffer = it->get();
+        bool orphaned           = buffer->orphaned.load(std::memory_order_acquire);
+
+        size_t tail = buffer->tail.load(std::memory_order_relaxed);
+        size_t head = buffer->head.load(std::memory_order_acquire);
+
+        while (tail != head)
+        {
+            uint32_t size;
+            copyFromBinaryLogBuffer(buffer, tail, &size, sizeof(size));
+            copyFromBinaryLogBuffer(buffer, tail + sizeof(size), binaryLogRecord, size);
+
+            fputc('L', binaryLogFile);
+            fwrite(&size, sizeof(size), 1, binaryLogFile);
+            fwrite(binaryLogRecord, 1, size, binaryLogFile);
+
+            tail += sizeof(size) + size;
+        }
+
+        buffer->tail.store(tail, std::memory_order_release);
+
+        // Everything the thread pushed is written
+        if (orphaned)
+            it = binaryLogBuffers.erase(it);
+        else
+            it++;
+    }
+
+    fflush(binaryLogFile);
+}
+
+// Writes every published record, from any thread
+// Returns false if another thread is already doing it
+static bool drainRecords()
+{
+    if (consumerLock.test_and_set(std::memory_order_acquire))
+        return false;
+
+    drainBinaryLogBuffers();
+
+    {
+        std::lock_guard<std::mutex> lock(logFileMutex);
+
+        while (true)
+        {
+            LogRecord* record = &records[dequeuePos & (LOG_QUEUE_SIZE - 1)];
+
+            if (record->sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+                break;
+
+            writeMessage(record->level, record->time, record->message, record->length);
+
+            record->sequence.store(dequeuePos + LOG_QUEUE_SIZE, std::memory_order_release);
+            dequeuePos++;
+        }
+
+        size_t dropped = droppedCount.load(std::memory_order_relaxed);
+
+        if (dropped != reportedDroppedCount)
+        {
+            std::string message = fmt::format("{} log message(s) dropped: too many messages", dropped - reportedDroppedCount);
+            writeMessage(LogLevel::WARNING, std::chrono::system_clock::now(), message.data(), message.size());
+
+            std::lock_guard<std::mutex> lock(binaryLogMutex);
+            if (binaryLogFile)
+            {
+                uint64_t count = dropped - reportedDroppedCount;
+
+                fputc('D', binaryLogFile);
+                fwrite(&count, sizeof(count), 1, binaryLogFile);
+                fflush(binaryLogFile);
+            }
+
+            reportedDroppedCount = dropped;
+        }
+
+        fflush(stdout);
+
+        if (logFile)
+            fflush(logFile);
+    }
+
+    flushedPos.store(dequeuePos, std::memory_order_release);
+    consumerLock.clear(std::memory_order_release);
+    return true;
+}
+
+static void writerMain()
+{
+    std::unique_lock<std::mutex> lock(writerMutex);
+
+    while (writerRunning)
+    {
+        writerCondition.wait_for(lock, LOG_WRITER_INTERVAL, [] { return writerWakeUp || !writerRunning; });
+        writerWakeUp = false;
+
+        writerDraining = true;
+        lock.unlock();
+        drainRecords();
+        lock.lock();
+        writerDraining = false;
+
+        drainCount++;
+        flushCondition.notify_all();
+    }
+}
+
+static void stopWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        writerRunning = false;
+    }
+
+    writerCondition.notify_one();
+
+    if (writerThread.joinable())
+        writerThread.join();
+
+    // Messages logged from now on are written synchronously
+    drainRecords();
+
+    std::lock_guard<std::mutex> lock(logFileMutex);
+    if (logFile)
+    {
+        logFileFd = -1;
+        fclose(logFile);
+        logFile = nullptr;
+    }
+}
+
+static void wakeUpWriter()
+{
+    writerWakeUp = true;
+    writerCondition.notify_one();
+}
+
+#ifdef LOG_CRASH_HANDLER
+static const int crashSignals[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+static void (*previousCrashHandlers[sizeof(crashSignals) / sizeof(int)])(int);
+
+static void writeFully(int fd, const char* data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, data, length);
+
+        if (written < 0 && errno == EINTR)
+            continue;
+
+        if (written <= 0)
+            return;
+
+        data += written;
+        length -= written;
+    }
+}
+
+static void writeCrashMessage(int fd, LogLevel level, const char* message, size_t length)
+{
+    const char* prefix = getLevelPrefix(level);
+
+    writeFully(fd, "[", 1);
+    writeFully(fd, prefix, strlen(prefix));
+    writeFully(fd, "] ", 2);
+    writeFully(fd, message, length);
+    writeFully(fd, "\n", 1);
+}
+
+// Writes the records that are already formatted with write(2) only: no lock,
+// no allocation and no stdio, as only async-signal-safe functions can be used
+// Nothing is written if the writer thread was interrupted while draining,
+// and the binary log and the dropped messages count are left as is
+static void crashHandler(int signal)
+{
+    if (!consumerLock.test_and_set(std::memory_order_acquire))
+    {
+        int fd = logFileFd.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            LogRecord* record = &records[dequeuePos & (LOG_QUEUE_SIZE - 1)];
+
+            if (record->sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+                break;
+
+            writeCrashMessage(STDOUT_FILENO, record->level, record->message, record->length);
+
+            if (fd >= 0)
+                writeCrashMessage(fd, record->level, record->message, record->length);
+
+            record->sequence.store(dequeuePos + LOG_QUEUE_SIZE, std::memory_order_release);
+            dequeuePos++;
+        }
+
+        flushedPos.store(dequeuePos, std::memory_order_release);
+        consumerLock.clear(std::memory_order_release);
+    }
+
+    for (size_t i = 0; i < sizeof(crashSignals) / sizeof(int); i++)
+    {
+        if (crashSignals[i] == signal)
+            ::signal(signal, previousCrashHandlers[i] != SIG_ERR ? previousCrashHandlers[i] : SIG_DFL);
+    }
+
+    raise(signal);
+}
+#endif
+
+static void startWriter()
+{
+    for (size_t i = 0; i < LOG_QUEUE_SIZE; i++)
+        records[i].sequence.store(i, std::memory_order_relaxed);
+
+    writerRunning = true;
+    writerThread  = std::thread(writerMain);
+
+    atexit(stopWriter);
+
+#ifdef LOG_CRASH_HANDLER
+    for (size_t i = 0; i < sizeof(crashSignals) / sizeof(int); i++)
+        previousCrashHandlers[i] = signal(crashSignals[i], crashHandler);
+#endif
+}
+
 void Logger::setLogLevel(LogLevel newLogLevel)
 {
     Logger::logLevel = newLogLevel;
 }
 
+bool Logger::setLogFile(std::string path, size_t maxSize, unsigned maxFiles)
+{
+    FILE* file = fopen(path.c_str(), "a");
+
+    if (!file)
+    {
+        BRLS_LOG_ERROR("Cannot open log file {}", path);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(logFileMutex);
+
+    if (logFile)
+    {
+        logFileFd = -1;
+        fclose(logFile);
+    }
+
+    fseek(file, 0, SEEK_END);
+
+    logFile         = file;
+    logFilePath     = path;
+    logFileSize     = ftell(file);
+    logFileMaxSize  = maxSize;
+    logFileMaxFiles = maxFiles;
+    logFileFd       = fileno(file);
+
+    return true;
+}
+
+bool Logger::setBinaryLogFile(std::string path)
+{
+    std::call_once(writerStarted, startWriter);
+
+    FILE* file = fopen(path.c_str(), "wb");
+
+    if (!file)
+    {
+        BRLS_LOG_ERROR("Cannot open binary log file {}", path);
+        return false;
+    }
+
+    uint32_t version = BINARY_LOG_VERSION;
+    fwrite(BINARY_LOG_MAGIC, 1, 4, file);
+    fwrite(&version, sizeof(version), 1, file);
+
+    {
+        std::lock_guard<std::mutex> lock(binaryLogMutex);
+
+        if (binaryLogFile)
+            fclose(binaryLogFile);
+
+        binaryLogFile           = file;
+        binaryLogFormatsWritten = 0;
+    }
+
+    Logger::binary = true;
+    return true;
+}
+
+void Logger::flush()
+{
+    std::unique_lock<std::mutex> lock(writerMutex);
+
+    if (!writerRunning)
+    {
+        lock.unlock();
+        drainRecords();
+        return;
+    }
+
+    // Wait for a drain that started after this call
+    size_t target = drainCount + (writerDraining ? 2 : 1);
+
+    wakeUpWriter();
+    flushCondition.wait(lock, [target] { return drainCount >= target || !writerRunning; });
+}
+
+size_t Logger::getDroppedCount()
+{
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+void Logger::vlog(LogLevel logLevel, fmt::string_view format, fmt::format_args args)
+{
+    std::call_once(writerStarted, startWriter);
+
+    thread_local fmt::memory_buffer buffer;
+    buffer.clear();
+
+    try
+    {
+        fmt::vformat_to(buffer, format, args);
+    }
+    catch (const std::exception& e)
+    {
+        buffer.clear();
+        fmt::format_to(buffer, "! Invalid log format string: \"{}\": {}", format, e.what());
+    }
+
+    // Claim a record
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    LogRecord* record;
+
+    while (true)
+    {
+        record       = &records[pos & (LOG_QUEUE_SIZE - 1)];
+        size_t seq   = record->sequence.load(std::memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+
+        if (dif == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (dif < 0)
+        {
+            // Full
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Fill and publish it
+    record->level  = logLevel;
+    record->time   = std::chrono::system_clock::now();
+    record->length = std::min(buffer.size(), (size_t)LOG_MESSAGE_MAX_LENGTH);
+
+    memcpy(record->message, buffer.data(), record->length);
+
+    if (buffer.size() > LOG_MESSAGE_MAX_LENGTH)
+        memcpy(record->message + LOG_MESSAGE_MAX_LENGTH - 3, "...", 3);
+
+    record->sequence.store(pos + 1, std::memory_order_release);
+
+    // Wake the writer up early for errors or if the ring buffer is filling up
+    if (!writerRunning)
+        drainRecords();
+    else if (logLevel == LogLevel::ERROR || pos - flushedPos.load(std::memory_order_relaxed) == LOG_QUEUE_SIZE / 2)
+        wakeUpWriter();
+}
+
+LogFormat::LogFormat(LogLevel level, const char* format, const char* file, int line)
+    : level(level)
+    , format(format)
+    , file(file)
+    , line(line)
+{
+    std::lock_guard<std::mutex> lock(binaryLogMutex);
+
+    this->id = binaryLogFormats.size();
+    binaryLogFormats.push_back(this);
+}
+
+void Logger::pushBinary(const LogFormat& format, const uint8_t* args, size_t argsSize, uint8_t argsCount)
+{
+    std::call_once(writerStarted, startWriter);
+
+    thread_local BinaryLogBufferOwner owner;
+
+    if (!owner.buffer)
+    {
+        std::lock_guard<std::mutex> lock(binaryLogMutex);
+
+        owner.buffer = new BinaryLogBuffer();
+        binaryLogBuffers.emplace_back(owner.buffer);
+    }
+
+    BinaryLogBuffer* buffer = owner.buffer;
+
+    uint32_t id   = format.id;
+    uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    uint32_t size = sizeof(id) + sizeof(time) + sizeof(argsCount) + argsSize;
+
+    size_t head = buffer->head.load(std::memory_order_relaxed);
+    size_t used = head - buffer->tail.load(std::memory_order_acquire);
+
+    if (used + sizeof(size) + size > BINARY_LOG_BUFFER_SIZE)
+    {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    copyToBinaryLogBuffer(buffer, head, &size, sizeof(size));
+    head += sizeof(size);
+    copyToBinaryLogBuffer(buffer, head, &id, sizeof(id));
+    head += sizeof(id);
+    copyToBinaryLogBuffer(buffer, head, &time, sizeof(time));
+    head += sizeof(time);
+    copyToBinaryLogBuffer(buffer, head, &argsCount, sizeof(argsCount));
+    head += sizeof(argsCount);
+    copyToBinaryLogBuffer(buffer, head, args, argsSize);
+    head += argsSize;
+
+    buffer->head.store(head, std::memory_order_release);
+
+    if (!writerRunning)
+        drainRecords();
+    else if (used + sizeof(size) + size > BINARY_LOG_BUFFER_SIZE / 2)
+        wakeUpWriter();
+}
+
 } // namespace brls
@@ -49,6 +49,7 @@ void MaterialIcon::setColor(NVGcolor color)
 {
     this->customColor    = color;
     this->useCustomColor = true;
+    this->invalidateDrawing();
 }
 
 NVGcolor MaterialIcon::getColor(Theme* theme)
@@ -0,0 +1,250 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+
+#include <algorithm>
+#include <borealis/application.hpp>
+#include <borealis/nine_slice.hpp>
+#include <vector>
+
+namespace brls
+{
+
+NineSlice::NineSlice(NVGcontext* vg, unsigned width, unsigned height, unsigned left, unsigned top, unsigned right, unsigned bottom, float scale, Coverage coverage)
+    : vg(vg)
+    , width(width)
+    , height(height)
+    , left(left)
+    , top(top)
+    , right(right)
+    , bottom(bottom)
+{
+    int pixelsWidth  = (int)ceilf(width * scale);
+    int pixelsHeight = (int)ceilf(height * scale);
+
+    this->textureWidth  = pixelsWidth / scale;
+    this->textureHeight = pixelsHeight / scale;
+
+    // Premultiplied white, the tint gives the color
+    std::vector<unsigned char> data(pixelsWidth * pixelsHeight * 4);
+
+    for (int y = 0; y < pixelsHeight; y++)
+    {
+        for (int x = 0; x < pixelsWidth; x++)
+        {
+            float alpha         = std::clamp(coverage((x + 0.5f) / scale, (y + 0.5f) / scale), 0.0f, 1.0f);
+            unsigned char value = (unsigned char)roundf(alpha * 255.0f);
+
+            unsigned char* pixel = &data[(y * pixelsWidth + x) * 4];
+            pixel[0] = pixel[1] = pixel[2] = pixel[3] = value;
+        }
+    }
+
+    this->image = nvgCreateImageRGBA(vg, pixelsWidth, pixelsHeight, NVG_IMAGE_PREMULTIPLIED, data.data());
+}
+
+bool NineSlice::draw(NVGcontext* vg, float x, float y, float width, float height, NVGcolor tint, bool drawCenter)
+{
+    if (width < this->left + this->right || height < this->top + this->bottom)
+        return false;
+
+    float destX[4] = { x, x + this->left, x + width - this->right, x + width };
+    float destY[4] = { y, y + this->top, y + height - this->bottom, y + height };
+
+    float srcX[4] = { 0.0f, (float)this->left, (float)(this->width - this->right), (float)this->width };
+    float srcY[4] = { 0.0f, (float)this->top, (float)(this->height - this->bottom), (float)this->height };
+
+    // Align the slices on device pixels so that their edges don't show seams
+    float transform[6];
+    nvgCurrentTransform(vg, transform);
+
+    if (transform[1] == 0.0f && transform[2] == 0.0f && transform[0] != 0.0f && transform[3] != 0.0f)
+    {
+        for (float& destination : destX)
+            destination = (roundf(destination * transform[0] + transform[4]) - transform[4]) / transform[0];
+
+        for (float& destination : destY)
+            destination = (roundf(destination * transform[3] + transform[5]) - transform[5]) / transform[3];
+    }
+
+    nvgSave(vg);
+    nvgShapeAntiAlias(vg, 0); // slices would overlap their neighbors antialiasing fringe
+
+    for (int row = 0; row < 3; row++)
+    {
+        for (int column = 0; column < 3; column++)
+        {
+            if (row == 1 && column == 1 && !drawCenter)
+                continue;
+
+            float sliceWidth  = destX[column + 1] - destX[column];
+            float sliceHeight = destY[row + 1] - destY[row];
+
+            if (sliceWidth <= 0.0f || sliceHeight <= 0.0f)
+                continue;
+
+            // Map the whole texture so that the slice lands on its destination
+            float scaleX = sliceWidth / (srcX[column + 1] - srcX[column]);
+            float scaleY = sliceHeight / (srcY[row + 1] - srcY[row]);
+
+            NVGpaint paint = nvgImagePattern(vg,
+                destX[column] - srcX[column] * scaleX, destY[row] - srcY[row] * scaleY,
+                this->textureWidth * scaleX, this->textureHeight * scaleY,
+                0.0f, this->image, 1.0f);
+
+            paint.innerColor = tint;
+            paint.outerColor = tint;
+
+            nvgBeginPath(vg);
+            nvgRect(vg, destX[column], destY[row], sliceWidth, sliceHeight);
+            nvgFillPaint(vg, paint);
+            nvgFill(vg);
+        }
+    }
+
+    nvgRestore(vg);
+
+    return true;
+}
+
+NineSlice::~NineSlice()
+{
+    nvgDeleteImage(this->vg, this->image);
+}
+
+// Signed distance to a rounded rect centered on the origin, same as nanovg shaders
+static float sdRoundRect(float x, float y, float extentX, float extentY, float radius)
+{
+    float dx = fabsf(x) - (extentX - radius);
+    float dy = fabsf(y) - (extentY - radius);
+
+    return std::min(std::max(dx, dy), 0.0f) + hypotf(std::max(dx, 0.0f), std::max(dy, 0.0f)) - radius;
+}
+
+void Decorations::drawShadow(NVGcontext* vg, float x, float y, float width, float height, float cornerRadius, float shadowWidth, float shadowFeather, float shadowOffset, NVGcolor color)
+{
+    float scale              = Application::windowScale;
+    std::array<float, 5> key = { cornerRadius, shadowWidth, shadowFeather, shadowOffset, scale };
+
+    unsigned pad = (unsigned)ceilf(shadowOffset);
+
+    NineSlice* shadow = nullptr;
+    auto it           = Decorations::shadows.find(key);
+
+    if (it != Decorations::shadows.end())
+    {
+        shadow = it->second;
+    }
+    else
+    {
+        // Texture of the shadow of a size x size rect, with corners large
+        // enough to hold both the gradient and the hole rounded corners
+        unsigned corner = (unsigned)ceilf(shadowWidth + cornerRadius * 2 + shadowFeather) + 1;
+        float size      = corner * 2 + 2;
+        float feather   = std::max(shadowFeather, 1.0f); // same as nvgBoxGradient
+
+        shadow = new NineSlice(vg, pad * 2 + size, pad * 3 + size, pad + corner, pad + corner, pad + corner, pad * 2 + corner, scale,
+            [pad, size, cornerRadius, shadowWidth, feather, shadowOffset, scale](float px, float py) {
+                float x = px - pad;
+                float y = py - pad;
+
+                if (x < -shadowOffset || x > size + shadowOffset || y < -shadowOffset || y > size + shadowOffset * 2)
+                    return 0.0f;
+
+                float gradient = std::clamp((sdRoundRect(x - size / 2, y - shadowWidth - size / 2, size / 2, size / 2, cornerRadius * 2) + feather * 0.5f) / feather, 0.0f, 1.0f);
+                float hole     = std::clamp(0.5f - sdRoundRect(x - size / 2, y - size / 2, size / 2, size / 2, cornerRadius) * scale, 0.0f, 1.0f);
+
+                return (1.0f - gradient) * (1.0f - hole);
+            });
+
+        Decorations::shadows[key] = shadow;
+    }
+
+    if (shadow->draw(vg, x - pad, y - pad, width + pad * 2, height + pad * 3, color, false))
+        return;
+
+    // Too small for the texture corners
+    NVGpaint shadowPaint = nvgBoxGradient(vg,
+        x, y + shadowWidth,
+        width, height,
+        cornerRadius * 2, shadowFeather,
+        color, nvgRGBA(0, 0, 0, 0));
+
+    nvgBeginPath(vg);
+    nvgRect(vg, x - shadowOffset, y - shadowOffset,
+        width + shadowOffset * 2, height + shadowOffset * 3);
+    nvgRoundedRect(vg, x, y, width, height, cornerRadius);
+    nvgPathWinding(vg, NVG_HOLE);
+    nvgFillPaint(vg, shadowPaint);
+    nvgFill(vg);
+}
+
+void Decorations::drawBorder(NVGcontext* vg, float x, float y, float width, float height, float cornerRadius, float strokeWidth, NVGcolor color)
+{
+    float scale              = Application::windowScale;
+    std::array<float, 3> key = { cornerRadius, strokeWidth, scale };
+
+    unsigned pad = (unsigned)ceilf(strokeWidth / 2) + 1;
+
+    NineSlice* border = nullptr;
+    auto it           = Decorations::borders.find(key);
+
+    if (it != Decorations::borders.end())
+    {
+        border = it->second;
+    }
+    else
+    {
+        unsigned corner = (unsigned)ceilf(cornerRadius) + 1;
+        float size      = corner * 2 + 2;
+
+        border = new NineSlice(vg, pad * 2 + size, pad * 2 + size, pad + corner, pad + corner, pad + corner, pad + corner, scale,
+            [pad, size, cornerRadius, strokeWidth, scale](float px, float py) {
+                // Antialiased over one device pixel
+                float distance = sdRoundRect(px - pad - size / 2, py - pad - size / 2, size / 2, size / 2, cornerRadius);
+                return (strokeWidth / 2 - fabsf(distance)) * scale + 0.5f;
+            });
+
+        Decorations::borders[key] = border;
+    }
+
+    if (border->draw(vg, x - pad, y - pad, width + pad * 2, height + pad * 2, color, false))
+        return;
+
+    // Too small for the texture corners
+    nvgBeginPath(vg);
+    nvgStrokeColor(vg, color);
+    nvgStrokeWidth(vg, strokeWidth);
+    nvgRoundedRect(vg, x, y, width, height, cornerRadius);
+    nvgStroke(vg);
+}
+
+void Decorations::clear()
+{
+    for (auto& shadow : Decorations::shadows)
+        delete shadow.second;
+
+    for (auto& border : Decorations::borders)
+        delete border.second;
+
+    Decorations::shadows.clear();
+    Decorations::borders.clear();
+}
+
+} // namespace brls
@@ -16,156 +16,236 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <borealis/application.hpp>
 #include <borealis/logger.hpp>
 #include <borealis/notification_manager.hpp>
-#include <cstring>
 
 // TODO: add a timeout duration enum for longer notifications
 
 namespace brls
 {
 
-NotificationManager::NotificationManager()
+void NotificationManager::frame(FrameContext* ctx)
 {
-    std::memset(this->notifications, 0, sizeof(Notification*) * BRLS_NOTIFICATIONS_MAX);
-}
-
-void NotificationManager::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
-{
-    for (size_t i = 0; i < BRLS_NOTIFICATIONS_MAX; i++)
     {
-        if (this->notifications[i])
-        {
-            Notification* notification = this->notifications[i];
+        std::lock_guard<std::mutex> lock(this->pendingMutex);
 
-            float alpha       = notification->getAlpha();
-            float translation = 0.0f;
+        if (!this->pendingNotifications.empty())
+        {
+            // Refill the rate limiting tokens
+            retro_time_t now = cpu_features_get_time_usec();
+            this->tokens     = std::min(this->tokens + (now - this->tokensTime) * BRLS_NOTIFICATIONS_RATE / 1000000.0f, (float)BRLS_NOTIFICATIONS_RATE);
+            this->tokensTime = now;
 
-            if (alpha != 1.0f)
+            // Coalesce or show pending notifications, keep the others for later
+            for (auto it = this->pendingNotifications.begin(); it != this->pendingNotifications.end();)
             {
-                translation = (1.0f - alpha) * (float)style->Notification.slideAnimation;
-                nvgTranslate(vg, translation, 0);
+                if (this->coalesceNotification(*it))
+                {
+                    it = this->pendingNotifications.erase(it);
+                }
+                else if (this->notifications.size() < BRLS_NOTIFICATIONS_MAX && this->tokens >= 1.0f)
+                {
+                    this->tokens -= 1.0f;
+                    this->showNotification(*it);
+                    it = this->pendingNotifications.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
             }
+        }
+    }
 
-            this->notifications[i]->frame(ctx);
+    View::frame(ctx);
+}
+
+void NotificationManager::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
+{
+    for (Notification* notification : this->notifications)
+    {
+        float alpha       = notification->getAlpha();
+        float translation = 0.0f;
 
-            if (alpha != 1.0f)
-                nvgTranslate(vg, -translation, 0);
+        if (alpha != 1.0f)
+        {
+            translation = (1.0f - alpha) * (float)style->Notification.slideAnimation;
+            nvgTranslate(vg, translation, 0);
         }
+
+        notification->frame(ctx);
+
+        if (alpha != 1.0f)
+            nvgTranslate(vg, -translation, 0);
     }
 }
 
 void NotificationManager::notify(std::string text)
 {
-    // Find the first available notification slot
-    bool found = false;
-    size_t i   = 0;
-    for (i = 0; i < BRLS_NOTIFICATIONS_MAX; i++)
+    std::lock_guard<std::mutex> lock(this->pendingMutex);
+
+    // Coalesce with a pending notification
+    for (PendingNotification& pending : this->pendingNotifications)
     {
-        if (!this->notifications[i])
+        if (pending.text == text)
         {
-            found = true;
-            break;
+            pending.count++;
+            return;
         }
     }
 
-    if (!found)
+    if (this->pendingNotifications.size() >= BRLS_NOTIFICATIONS_QUEUE_MAX)
     {
-        brls::Logger::warning("Discarding notification \"{}\"", text);
+        BRLS_LOG_WARNING("Discarding notification \"{}\"", text);
         return;
     }
 
-    // Create the notification
-    brls::Logger::debug("Showing notification \"{}\"", text);
+    this->pendingNotifications.push_back({ text, 1 });
+}
+
+bool NotificationManager::coalesceNotification(const PendingNotification& pending)
+{
+    for (Notification* notification : this->notifications)
+    {
+        // Don't revive notifications that are going away
+        if (notification->isHidden() || notification->getText() != pending.text)
+            continue;
+
+        notification->setText(pending.text, notification->getCount() + pending.count);
+        this->startTimeout(notification);
+        this->layoutNotifications(); // the text can be one line longer
+
+        return true;
+    }
+
+    return false;
+}
+
+void NotificationManager::showNotification(const PendingNotification& pending)
+{
+    BRLS_LOG_DEBUG("Showing notification \"{}\"", pending.text);
+
+    Notification* notification = nullptr;
+
+    if (!this->pool.empty())
+    {
+        notification = this->pool.back();
+        this->pool.pop_back();
+    }
+    else
+    {
+        notification = new Notification();
+        notification->setParent(this);
+    }
 
-    Notification* notification = new Notification(text);
-    notification->setParent(this);
+    notification->setText(pending.text, pending.count);
     notification->show([]() {});
 
-    // Timeout timer
+    this->startTimeout(notification);
+
+    this->notifications.push_back(notification);
+    this->layoutNotifications();
+}
+
+void NotificationManager::startTimeout(Notification* notification)
+{
     menu_timer_ctx_entry_t entry;
 
     entry.duration = Application::getStyle()->AnimationDuration.notificationTimeout;
     entry.tick     = [](void*) {};
     entry.userdata = nullptr;
-    entry.cb       = [this, notification, i](void* userdata) {
-        notification->hide([this, notification, i]() {
-            delete notification;
-            this->notifications[i] = nullptr;
+    entry.cb       = [this, notification](void* userdata) {
+        notification->hide([this, notification]() {
+            this->removeNotification(notification);
         });
     };
 
     menu_timer_start(&notification->timeoutTimer, &entry);
-
-    this->notifications[i] = notification;
-
-    // Layout the notification
-    this->layoutNotification(i);
 }
 
-void NotificationManager::layoutNotification(size_t index)
+void NotificationManager::removeNotification(Notification* notification)
 {
-    Notification* notification = this->notifications[index];
+    auto it = std::find(this->notifications.begin(), this->notifications.end(), notification);
 
-    if (!notification)
+    if (it == this->notifications.end())
         return;
 
-    Style* style = Application::getStyle();
+    this->notifications.erase(it);
+    this->pool.push_back(notification);
 
-    // Get the position of the last notification
-    Notification* lastNotification = nullptr;
-    for (size_t i = 0; i < index; i++)
-    {
-        if (this->notifications[i])
-            lastNotification = this->notifications[i];
-    }
-
-    unsigned y = lastNotification ? (lastNotification->getY() + lastNotification->getHeight()) : 0;
+    this->layoutNotifications();
+}
 
-    // Layout the notification
+void NotificationManager::layoutNotifications()
+{
+    Style* style   = Application::getStyle();
     unsigned width = style->Notification.width;
-    notification->setBoundaries(
-        this->getX() + this->getWidth() - width,
-        this->getY() + y,
-        width,
-        0 // height is dynamic
-    );
+    unsigned y     = 0;
+
+    // Stack notifications below each other
+    for (Notification* notification : this->notifications)
+    {
+        notification->setBoundaries(
+            this->getX() + this->getWidth() - width,
+            this->getY() + y,
+            width,
+            0 // height is dynamic
+        );
+
+        notification->invalidate(true); // layout directly to get the height
 
-    notification->invalidate(); // TODO: call layout directly to fix posting multiple notifications in one frame
+        y += notification->getHeight();
+    }
 }
 
 void NotificationManager::layout(NVGcontext* vg, Style* style, FontStash* stash)
 {
-    for (size_t i = 0; i < BRLS_NOTIFICATIONS_MAX; i++)
-    {
-        if (this->notifications[i])
-            this->layoutNotification(i);
-    }
+    this->layoutNotifications();
 }
 
 NotificationManager::~NotificationManager()
 {
-    for (size_t i = 0; i < BRLS_NOTIFICATIONS_MAX; i++)
-    {
-        if (this->notifications[i])
-            delete this->notifications[i];
-    }
+    for (Notification* notification : this->notifications)
+        delete notification;
+
+    for (Notification* notification : this->pool)
+        delete notification;
 }
 
-Notification::Notification(std::string text)
+Notification::Notification()
 {
     this->setBackground(ViewBackground::BACKDROP);
 
-    this->label = new Label(LabelStyle::NOTIFICATION, text, true);
+    this->label = new Label(LabelStyle::NOTIFICATION, "", true);
     label->setParent(this);
 }
 
 Notification::~Notification()
 {
+    menu_timer_kill(&this->timeoutTimer);
     delete this->label;
 }
 
+void Notification::setText(std::string text, unsigned count)
+{
+    this->text  = text;
+    this->count = count;
+
+    this->label->setText(count > 1 ? fmt::format("{} (x{})", text, count) : text);
+}
+
+const std::string& Notification::getText()
+{
+    return this->text;
+}
+
+unsigned Notification::getCount()
+{
+    return this->count;
+}
+
 void Notification::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
 {
     this->label->frame(ctx);
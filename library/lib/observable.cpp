@@ -0,0 +1,96 @@
+/*
+    Borealis, a Nintendo Switch UI Library
+    Copyright (C) 2020  natinusala
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <borealis/observable.hpp>
+
+namespace brls
+{
+
+ObservableBase::~ObservableBase()
+{
+    if (!this->pending)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(ObservableBase::pendingMutex);
+
+        auto it = std::find(ObservableBase::pendingObservables.begin(), ObservableBase::pendingObservables.end(), this);
+        if (it != ObservableBase::pendingObservables.end())
+            ObservableBase::pendingObservables.erase(it);
+    }
+
+    // Destroyed by a callback while flushing
+    std::replace(ObservableBase::flushingObservables.begin(), ObservableBase::flushingObservables.end(), this, (ObservableBase*)nullptr);
+}
+
+void ObservableBase::setThrottle(unsigned throttle)
+{
+    this->throttle = throttle;
+}
+
+void ObservableBase::markDirty()
+{
+    // Already scheduled, the latest value will be used
+    if (this->pending.exchange(true))
+        return;
+
+    std::lock_guard<std::mutex> lock(ObservableBase::pendingMutex);
+    ObservableBase::pendingObservables.push_back(this);
+}
+
+void ObservableBase::flushAll()
+{
+    {
+        std::lock_guard<std::mutex> lock(ObservableBase::pendingMutex);
+
+        if (ObservableBase::pendingObservables.empty())
+            return;
+
+        std::swap(ObservableBase::pendingObservables, ObservableBase::flushingObservables);
+    }
+
+    retro_time_t now = cpu_features_get_time_usec() / 1000;
+
+    // Observables set by the callbacks are flushed on the next frame
+    for (size_t i = 0; i < ObservableBase::flushingObservables.size(); i++)
+    {
+        ObservableBase* observable = ObservableBase::flushingObservables[i];
+
+        if (!observable)
+            continue;
+
+        // Throttled, keep it for a later frame
+        if (observable->throttle > 0 && now - observable->lastFlush < observable->throttle)
+        {
+            std::lock_guard<std::mutex> lock(ObservableBase::pendingMutex);
+            ObservableBase::pendingObservables.push_back(observable);
+            continue;
+        }
+
+        // Cleared before reading the value so that a concurrent set schedules it again
+        observable->pending   = false;
+        observable->lastFlush = now;
+
+        observable->flush();
+    }
+
+    ObservableBase::flushingObservables.clear();
+}
+
+} // namespace brls
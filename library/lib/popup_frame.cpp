@@ -24,43 +24,16 @@
 #include <borealis/logger.hpp>
 #include <borealis/popup_frame.hpp>
 
-using namespace brls::i18n::literals;
-
 namespace brls
 {
 
-PopupFrame::PopupFrame(std::string title, unsigned char* imageBuffer, size_t imageBufferSize, AppletFrame* contentView, std::string subTitleLeft, std::string subTitleRight)
-    : contentView(contentView)
+static const ActionTable* getPopupFrameActions()
 {
-    if (this->contentView)
-    {
-        this->contentView->setParent(this);
-        this->contentView->setHeaderStyle(HeaderStyle::POPUP);
-        this->contentView->setTitle(title);
-        this->contentView->setSubtitle(subTitleLeft, subTitleRight);
-        this->contentView->setIcon(imageBuffer, imageBufferSize);
-        this->contentView->invalidate();
-    }
+    static const ActionTable actions = {
+        memberAction(i18n::Translation("brls/hints/back"), Key::B, &PopupFrame::onCancel),
+    };
 
-    contentView->setAnimateHint(true);
-    this->registerAction("brls/hints/back"_i18n, Key::B, [this] { return this->onCancel(); });
-}
-
-PopupFrame::PopupFrame(std::string title, std::string imagePath, AppletFrame* contentView, std::string subTitleLeft, std::string subTitleRight)
-    : contentView(contentView)
-{
-    if (this->contentView)
-    {
-        this->contentView->setParent(this);
-        this->contentView->setHeaderStyle(HeaderStyle::POPUP);
-        this->contentView->setTitle(title);
-        this->contentView->setSubtitle(subTitleLeft, subTitleRight);
-        this->contentView->setIcon(imagePath);
-        this->contentView->invalidate();
-    }
-
-    contentView->setAnimateHint(true);
-    this->registerAction("brls/hints/back"_i18n, Key::B, [this] { return this->onCancel(); });
+    return &actions;
 }
 
 PopupFrame::PopupFrame(std::string title, AppletFrame* contentView, std::string subTitleLeft, std::string subTitleRight)
@@ -72,11 +45,11 @@ PopupFrame::PopupFrame(std::string title, AppletFrame* contentView, std::string
         this->contentView->setHeaderStyle(HeaderStyle::POPUP);
         this->contentView->setTitle(title);
         this->contentView->setSubtitle(subTitleLeft, subTitleRight);
+        this->contentView->setAnimateHint(true);
         this->contentView->invalidate();
     }
 
-    contentView->setAnimateHint(true);
-    this->registerAction("brls/hints/back"_i18n, Key::B, [this] { return this->onCancel(); });
+    this->setActionTable(getPopupFrameActions());
 }
 
 void PopupFrame::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
@@ -131,13 +104,21 @@ View* PopupFrame::getDefaultFocus()
 
 void PopupFrame::open(std::string title, unsigned char* imageBuffer, size_t imageBufferSize, AppletFrame* contentView, std::string subTitleLeft, std::string subTitleRight)
 {
-    PopupFrame* popupFrame = new PopupFrame(title, imageBuffer, imageBufferSize, contentView, subTitleLeft, subTitleRight);
+    PopupFrame* popupFrame = new PopupFrame(title, contentView, subTitleLeft, subTitleRight);
+
+    if (contentView)
+        contentView->setIcon(imageBuffer, imageBufferSize);
+
     Application::pushView(popupFrame);
 }
 
 void PopupFrame::open(std::string title, std::string imagePath, AppletFrame* contentView, std::string subTitleLeft, std::string subTitleRight)
 {
-    PopupFrame* popupFrame = new PopupFrame(title, imagePath, contentView, subTitleLeft, subTitleRight);
+    PopupFrame* popupFrame = new PopupFrame(title, contentView, subTitleLeft, subTitleRight);
+
+    if (contentView)
+        contentView->setIcon(imagePath);
+
     Application::pushView(popupFrame);
 }
 
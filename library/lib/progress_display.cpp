@@ -37,6 +37,7 @@ void ProgressDisplay::setProgress(int current, int max)
         return;
 
     this->progressPercentage = ((current * 100) / max);
+    this->invalidateDrawing();
 
     if (!this->label)
         return;
@@ -108,6 +109,8 @@ void ProgressDisplay::draw(NVGcontext* vg, int x, int y, unsigned width, unsigne
         nvgLineCap(vg, NVG_ROUND);
         nvgStroke(vg);
     }
+
+    nvgLineCap(vg, NVG_BUTT); // restore the default, the state is not saved
 }
 
 void ProgressDisplay::willAppear(bool resetState)
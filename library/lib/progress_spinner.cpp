@@ -45,7 +45,7 @@ void ProgressSpinner::restartAnimation()
     entry.subject      = &this->animationValue;
     entry.tag          = tag;
     entry.target_value = 8.0f;
-    entry.tick         = [](void* userdata) {};
+    entry.tick         = [this](void* userdata) { this->invalidateDrawing(); };
     entry.userdata     = nullptr;
 
     menu_animation_push(&entry);
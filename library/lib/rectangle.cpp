@@ -45,6 +45,7 @@ void Rectangle::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned heig
 void Rectangle::setColor(NVGcolor color)
 {
     this->color = color;
+    this->invalidateDrawing();
 }
 
 void Rectangle::layout(NVGcontext* vg, Style* style, FontStash* stash)
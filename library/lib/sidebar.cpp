@@ -22,8 +22,6 @@
 #include <borealis/i18n.hpp>
 #include <borealis/sidebar.hpp>
 
-using namespace brls::i18n::literals;
-
 namespace brls
 {
 
@@ -100,7 +98,11 @@ SidebarItem::SidebarItem(std::string label, Sidebar* sidebar)
     Style* style = Application::getStyle();
     this->setHeight(style->Sidebar.Item.height);
 
-    this->registerAction("brls/hints/ok"_i18n, Key::A, [this] { return this->onClick(); });
+    static const ActionTable actions = {
+        memberAction(i18n::Translation("brls/hints/ok"), Key::A, &SidebarItem::onClick),
+    };
+
+    this->setActionTable(&actions);
 }
 
 void SidebarItem::draw(NVGcontext* vg, int x, int y, unsigned width, unsigned height, Style* style, FrameContext* ctx)
@@ -132,6 +134,7 @@ bool SidebarItem::onClick()
 void SidebarItem::setActive(bool active)
 {
     this->active = active;
+    this->invalidateDrawing();
 }
 
 SidebarSeparator::SidebarSeparator()
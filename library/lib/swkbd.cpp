@@ -117,7 +117,7 @@ bool Swkbd::openForNumber(std::function<void(int)> f, std::string headerText, st
     }
     catch (const std::exception& e)
     {
-        Logger::error("Could not parse input, did you enter a valid integer?");
+        BRLS_LOG_ERROR("Could not parse input, did you enter a valid integer?");
         return false;
     }
 #endif
@@ -20,8 +20,6 @@
 #include <borealis/i18n.hpp>
 #include <borealis/thumbnail_frame.hpp>
 
-using namespace brls::i18n::literals;
-
 namespace brls
 {
 
@@ -83,7 +81,7 @@ ThumbnailSidebar::ThumbnailSidebar()
     this->setBackground(ViewBackground::SIDEBAR);
     this->setWidth(style->Sidebar.width);
 
-    this->button = (new Button(ButtonStyle::PRIMARY))->setLabel("brls/thumbnail_sidebar/save"_i18n);
+    this->button = (new Button(ButtonStyle::PRIMARY))->setLabel(i18n::Translation("brls/thumbnail_sidebar/save"));
     this->button->setParent(this);
 }
 
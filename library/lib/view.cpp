@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <borealis/animations.hpp>
 #include <borealis/application.hpp>
+#include <borealis/nine_slice.hpp>
 #include <borealis/view.hpp>
 
 namespace brls
@@ -39,10 +40,20 @@ static int shakeAnimation(float t, float a) // a = amplitude
 
 void View::shakeHighlight(FocusDirection direction)
 {
-    this->highlightShaking        = true;
-    this->highlightShakeStart     = cpu_features_get_time_usec() / 1000;
-    this->highlightShakeDirection = direction;
-    this->highlightShakeAmplitude = std::rand() % 15 + 10;
+    ViewExtras* extras = this->getExtras();
+
+    this->highlightShaking          = true;
+    extras->highlightShakeStart     = cpu_features_get_time_usec() / 1000;
+    extras->highlightShakeDirection = direction;
+    extras->highlightShakeAmplitude = std::rand() % 15 + 10;
+}
+
+ViewExtras* View::getExtras()
+{
+    if (!this->extras)
+        this->extras = new ViewExtras();
+
+    return this->extras;
 }
 
 float View::getAlpha(bool child)
@@ -71,8 +82,6 @@ void View::frame(FrameContext* ctx)
     Style* style    = Application::getStyle();
     Theme* oldTheme = ctx->theme;
 
-    nvgSave(ctx->vg);
-
     // Theme override
     if (this->themeOverride)
         ctx->theme = themeOverride;
@@ -93,11 +102,16 @@ void View::frame(FrameContext* ctx)
         if (this->highlightAlpha > 0.0f && this->isHighlightBackgroundEnabled())
             this->drawHighlight(ctx->vg, ctx->theme, this->highlightAlpha, style, true);
 
-        // Collapse clipping
+        // Collapse clipping, the only state change of frame() itself
         if (this->collapseState < 1.0f)
         {
             nvgSave(ctx->vg);
             nvgIntersectScissor(ctx->vg, x, y, this->width, this->height * this->collapseState);
+            ctx->stateSaves++;
+        }
+        else
+        {
+            ctx->stateSavesAvoided++;
         }
 
         // Draw the view
@@ -115,8 +129,6 @@ void View::frame(FrameContext* ctx)
     // Cleanup
     if (this->themeOverride)
         ctx->theme = oldTheme;
-
-    nvgRestore(ctx->vg);
 }
 
 void View::collapse(bool animated)
@@ -200,8 +212,9 @@ void View::drawHighlight(NVGcontext* vg, Theme* theme, float alpha, Style* style
     // Shake animation
     if (this->highlightShaking)
     {
+        ViewExtras* extras   = this->extras;
         retro_time_t curTime = cpu_features_get_time_usec() / 1000;
-        retro_time_t t       = (curTime - highlightShakeStart) / 10;
+        retro_time_t t       = (curTime - extras->highlightShakeStart) / 10;
 
         if (t >= style->AnimationDuration.shake)
         {
@@ -209,19 +222,19 @@ void View::drawHighlight(NVGcontext* vg, Theme* theme, float alpha, Style* style
         }
         else
         {
-            switch (this->highlightShakeDirection)
+            switch (extras->highlightShakeDirection)
             {
                 case FocusDirection::RIGHT:
-                    x += shakeAnimation(t, this->highlightShakeAmplitude);
+                    x += shakeAnimation(t, extras->highlightShakeAmplitude);
                     break;
                 case FocusDirection::LEFT:
-                    x -= shakeAnimation(t, this->highlightShakeAmplitude);
+                    x -= shakeAnimation(t, extras->highlightShakeAmplitude);
                     break;
                 case FocusDirection::DOWN:
-                    y += shakeAnimation(t, this->highlightShakeAmplitude);
+                    y += shakeAnimation(t, extras->highlightShakeAmplitude);
                     break;
                 case FocusDirection::UP:
-                    y -= shakeAnimation(t, this->highlightShakeAmplitude);
+                    y -= shakeAnimation(t, extras->highlightShakeAmplitude);
                     break;
                 default:
                     break;
@@ -241,19 +254,9 @@ void View::drawHighlight(NVGcontext* vg, Theme* theme, float alpha, Style* style
     else
     {
         // Shadow
-        NVGpaint shadowPaint = nvgBoxGradient(vg,
-            x, y + style->Highlight.shadowWidth,
-            width, height,
-            cornerRadius * 2, style->Highlight.shadowFeather,
-            RGBA(0, 0, 0, style->Highlight.shadowOpacity * alpha), transparent);
-
-        nvgBeginPath(vg);
-        nvgRect(vg, x - style->Highlight.shadowOffset, y - style->Highlight.shadowOffset,
-            width + style->Highlight.shadowOffset * 2, height + style->Highlight.shadowOffset * 3);
-        nvgRoundedRect(vg, x, y, width, height, cornerRadius);
-        nvgPathWinding(vg, NVG_HOLE);
-        nvgFillPaint(vg, shadowPaint);
-        nvgFill(vg);
+        Decorations::drawShadow(vg, x, y, width, height,
+            cornerRadius, style->Highlight.shadowWidth, style->Highlight.shadowFeather, style->Highlight.shadowOffset,
+            RGBA(0, 0, 0, style->Highlight.shadowOpacity * alpha));
 
         // Border
         float gradientX, gradientY, color;
@@ -277,12 +280,9 @@ void View::drawHighlight(NVGcontext* vg, Theme* theme, float alpha, Style* style
             style->Highlight.strokeWidth * 10, style->Highlight.strokeWidth * 40,
             borderColor, transparent);
 
-        nvgBeginPath(vg);
-        nvgStrokeColor(vg, pulsationColor);
-        nvgStrokeWidth(vg, style->Highlight.strokeWidth);
-        nvgRoundedRect(vg, x, y, width, height, cornerRadius);
-        nvgStroke(vg);
+        Decorations::drawBorder(vg, x, y, width, height, cornerRadius, style->Highlight.strokeWidth, pulsationColor);
 
+        // The gradients move along the border every frame, they can't be cached
         nvgBeginPath(vg);
         nvgStrokePaint(vg, border1Paint);
         nvgStrokeWidth(vg, style->Highlight.strokeWidth);
@@ -354,26 +354,106 @@ void View::drawBackground(NVGcontext* vg, FrameContext* ctx, Style* style)
     }
 }
 
+const Action* View::getAction(Key key) const
+{
+    if (this->actionKeys & getKeyMask(key))
+    {
+        for (const Action& action : this->extras->actions)
+        {
+            if (action.key == key)
+                return &action;
+        }
+    }
+
+    return this->actionTable ? this->actionTable->find(key) : nullptr;
+}
+
+Action* View::getOwnAction(Key key)
+{
+    if (this->actionKeys & getKeyMask(key))
+    {
+        for (Action& action : this->extras->actions)
+        {
+            if (action.key == key)
+                return &action;
+        }
+    }
+
+    // Copy the shared action before changing it
+    if (const Action* tableAction = this->actionTable ? this->actionTable->find(key) : nullptr)
+    {
+        ViewExtras* extras = this->getExtras();
+
+        extras->actions.push_back(*tableAction);
+        this->actionKeys |= getKeyMask(key);
+        return &extras->actions.back();
+    }
+
+    return nullptr;
+}
+
+bool View::fireAction(const Action& action)
+{
+    if (action.actionMember)
+        return (this->*action.actionMember)();
+
+    return action.actionListener();
+}
+
 void View::registerAction(std::string hintText, Key key, ActionListener actionListener, bool hidden)
 {
-    if (auto it = std::find(this->actions.begin(), this->actions.end(), key); it != this->actions.end())
-        *it = { key, hintText, true, hidden, actionListener };
+    if (!(this->getActionKeys() & getKeyMask(key)))
+        Application::invalidateActionChain();
+
+    if (Action* action = this->getOwnAction(key))
+    {
+        *action = { key, hintText, true, hidden, actionListener, std::nullopt };
+    }
     else
-        this->actions.push_back({ key, hintText, true, hidden, actionListener });
+    {
+        this->getExtras()->actions.push_back({ key, hintText, true, hidden, actionListener, std::nullopt });
+        this->actionKeys |= getKeyMask(key);
+    }
+}
+
+void View::registerAction(i18n::Translation hintText, Key key, ActionListener actionListener, bool hidden)
+{
+    this->registerAction("", key, actionListener, hidden);
+    this->getOwnAction(key)->hintTranslation = hintText;
 }
 
 void View::updateActionHint(Key key, std::string hintText)
 {
-    if (auto it = std::find(this->actions.begin(), this->actions.end(), key); it != this->actions.end())
-        it->hintText = hintText;
+    if (Action* action = this->getOwnAction(key))
+    {
+        action->hintText = hintText;
+        action->hintTranslation.reset();
+    }
+
+    Application::getGlobalHintsUpdateEvent()->fire();
+}
+
+void View::updateActionHint(Key key, i18n::Translation hintText)
+{
+    if (Action* action = this->getOwnAction(key))
+        action->hintTranslation = hintText;
 
     Application::getGlobalHintsUpdateEvent()->fire();
 }
 
 void View::setActionAvailable(Key key, bool available)
 {
-    if (auto it = std::find(this->actions.begin(), this->actions.end(), key); it != this->actions.end())
-        it->available = available;
+    if (const Action* action = this->getAction(key); action && action->available == available)
+        return;
+
+    if (Action* action = this->getOwnAction(key))
+        action->available = available;
+}
+
+void View::setActionTable(const ActionTable* actionTable)
+{
+    this->actionTable = actionTable;
+    Application::invalidateActionChain();
 }
 
 void View::setBoundaries(int x, int y, unsigned width, unsigned height)
@@ -388,6 +468,8 @@ void View::setParent(View* parent, void* parentUserdata)
 {
     this->parent         = parent;
     this->parentUserdata = parentUserdata;
+
+    Application::invalidateActionChain();
 }
 
 void* View::getParentUserData()
@@ -455,12 +537,13 @@ void View::onFocusGained()
     entry.subject      = &this->highlightAlpha;
     entry.tag          = tag;
     entry.target_value = 1.0f;
-    entry.tick         = [](void* userdata) {};
+    entry.tick         = [this](void* userdata) { this->invalidateDrawing(); };
     entry.userdata     = nullptr;
 
     menu_animation_push(&entry);
 
-    this->focusEvent.fire(this);
+    if (this->extras)
+        this->extras->focusEvent.fire(this);
 
     if (this->hasParent())
         this->getParent()->onChildFocusGained(this);
@@ -468,7 +551,7 @@ void View::onFocusGained()
 
 GenericEvent* View::getFocusEvent()
 {
-    return &this->focusEvent;
+    return &this->getExtras()->focusEvent;
 }
 
 /**
@@ -489,7 +572,7 @@ void View::onFocusLost()
     entry.subject      = &this->highlightAlpha;
     entry.tag          = tag;
     entry.target_value = 0.0f;
-    entry.tick         = [](void* userdata) {};
+    entry.tick         = [this](void* userdata) { this->invalidateDrawing(); };
     entry.userdata     = nullptr;
 
     menu_animation_push(&entry);
@@ -515,7 +598,7 @@ unsigned View::getShowAnimationDuration(ViewAnimation animation)
 
 void View::show(std::function<void(void)> cb, bool animate, ViewAnimation animation)
 {
-    brls::Logger::debug("Showing {} with animation {}", this->describe(), animation);
+    BRLS_LOG_DEBUG("Showing {} with animation {}", this->describe(), animation);
 
     this->hidden = false;
 
@@ -539,7 +622,7 @@ void View::show(std::function<void(void)> cb, bool animate, ViewAnimation animat
         entry.subject      = &this->alpha;
         entry.tag          = tag;
         entry.target_value = 1.0f;
-        entry.tick         = [](void* userdata) {};
+        entry.tick         = [this](void* userdata) { this->invalidateDrawing(); };
         entry.userdata     = nullptr;
 
         menu_animation_push(&entry);
@@ -555,7 +638,7 @@ void View::show(std::function<void(void)> cb, bool animate, ViewAnimation animat
 
 void View::hide(std::function<void(void)> cb, bool animated, ViewAnimation animation)
 {
-    brls::Logger::debug("Hiding {} with animation {}", this->describe(), animation);
+    BRLS_LOG_DEBUG("Hiding {} with animation {}", this->describe(), animation);
 
     this->hidden = true;
     this->fadeIn = false;
@@ -574,7 +657,7 @@ void View::hide(std::function<void(void)> cb, bool animated, ViewAnimation anima
         entry.subject      = &this->alpha;
         entry.tag          = tag;
         entry.target_value = 0.0f;
-        entry.tick         = [](void* userdata) {};
+        entry.tick         = [this](void* userdata) { this->invalidateDrawing(); };
         entry.userdata     = nullptr;
 
         menu_animation_push(&entry);
@@ -598,6 +681,8 @@ void View::overrideThemeVariant(Theme* theme)
 
 View::~View()
 {
+    Application::invalidateActionChain();
+
     menu_animation_ctx_tag alphaTag = (uintptr_t) & this->alpha;
     menu_animation_kill_by_tag(&alphaTag);
 
@@ -614,6 +699,8 @@ View::~View()
         this->parentUserdata = nullptr;
     }
 
+    delete this->extras;
+
     // Focus sanity check
     if (Application::getCurrentFocus() == this)
         Application::giveFocus(nullptr);
@@ -625,6 +712,13 @@ void View::invalidate(bool immediate)
         this->layout(Application::getNVGContext(), Application::getStyle(), Application::getFontStash());
     else
         this->dirty = true;
+
+    this->invalidateDrawing();
+}
+
+void View::invalidateDrawing()
+{
+    Application::invalidateSnapshot(this);
 }
 
 } // namespace brls
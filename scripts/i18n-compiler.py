@@ -0,0 +1,146 @@
+"""
+Borealis, a Nintendo Switch UI Library
+Copyright (C) 2020  natinusala
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+"""
+# Run with Python 3
+
+# Compiles every JSON file of an i18n folder into a binary catalog
+# next to it (brls.json -> brls.bin), loaded instead of the JSON file at runtime
+#
+# Catalog format (little endian):
+#   - header: magic "BRLS", version (u32), strings count (u32), pool size (u32)
+#   - index: one (hash (u64), offset (u32), length (u32)) entry per string, sorted by hash
+#   - pool: all strings, UTF-8 encoded and NUL terminated
+#
+# Hashes are 64 bits FNV-1a hashes of full string names ("brls/hints/ok"),
+# see brls::i18n::internal::hashStr
+
+import argparse
+import json
+import struct
+from pathlib import Path
+
+_CATALOG_MAGIC = b"BRLS"
+_CATALOG_VERSION = 1
+
+_FNV_OFFSET_BASIS = 0xcbf29ce484222325
+_FNV_PRIME = 0x100000001b3
+
+
+def _hash_str(string: str) -> int:
+    """64 bits FNV-1a hash, must match brls::i18n::internal::hashStr"""
+    hash = _FNV_OFFSET_BASIS
+    for byte in string.encode("utf-8"):
+        hash ^= byte
+        hash = (hash * _FNV_PRIME) & 0xffffffffffffffff
+    return hash
+
+
+def _flatten(breadcrumb: str, value, strings: dict, errors: list):
+    """Flattens a JSON tree into {string name -> string}"""
+    # Dict
+    if isinstance(value, dict):
+        for nested_key in value:
+            _flatten(f"{breadcrumb}/{nested_key}", value[nested_key], strings, errors)
+    # Str
+    elif isinstance(value, str):
+        strings[breadcrumb] = value
+    # Anything else
+    else:
+        errors.append(f"String \"{breadcrumb}\" contains data \"{str(value)}\" of invalid type \"{type(value).__name__}\"")
+
+
+def _compile_file(path: Path, errors: list) -> bool:
+    """Compiles one JSON file to its binary catalog, returns True if successful"""
+    with open(path, "r") as jsonf:
+        try:
+            tree = json.loads(jsonf.read())
+        except json.JSONDecodeError as e:
+            errors.append(f"Cannot parse JSON file \"{path}\": {e}")
+            return False
+
+    strings = {}
+    _flatten(path.stem, tree, strings, errors)
+
+    # Hash and check for collisions
+    hashes = {}
+    for name in strings:
+        hash = _hash_str(name)
+
+        if hash in hashes:
+            errors.append(f"Strings \"{name}\" and \"{hashes[hash]}\" of \"{path}\" have the same hash")
+            return False
+
+        hashes[hash] = name
+
+    # Build index and pool
+    index = bytearray()
+    pool = bytearray()
+
+    for hash in sorted(hashes):
+        encoded = strings[hashes[hash]].encode("utf-8")
+        index += struct.pack("<QII", hash, len(pool), len(encoded))
+        pool += encoded + b"\0"
+
+    header = _CATALOG_MAGIC + struct.pack("<III", _CATALOG_VERSION, len(hashes), len(pool))
+
+    with open(path.with_suffix(".bin"), "wb") as binf:
+        binf.write(header + index + pool)
+
+    return True
+
+
+if __name__ == "__main__":
+    # Arguments parsing
+    parser = argparse.ArgumentParser(description="Compile i18n strings to binary catalogs")
+
+    parser.add_argument(
+        dest="path",
+        action="store",
+        help="The path to the i18n folder to compile",
+    )
+
+    args = parser.parse_args()
+
+    path = Path(args.path)
+
+    if not path.is_dir():
+        print(f"Cannot compile i18n folder: \"{path}\" is not a folder")
+        exit(1)
+
+    print(f"Compiling i18n folder {path}...\n")
+
+    errors = []
+    compiled = 0
+
+    for locale in sorted(path.iterdir()):
+        if not locale.is_dir():
+            continue
+
+        for f in sorted(locale.glob("*.json")):
+            if _compile_file(f, errors):
+                compiled += 1
+
+    if errors:
+        print(f"{len(errors)} error(s):")
+
+        for error in errors:
+            print(f"     - {error}")
+
+        print("\nPlease fix them (see i18n-linter.py) and run the script again.")
+        exit(1)
+
+    print(f"Compiled {compiled} file(s), your i18n folder is good to go!")
@@ -95,6 +95,9 @@ def _check_locales(path: Path, errors: list, warnings: list) -> tuple:
                 # Directory
                 if ff.is_dir():
                     warnings.append((1, f"{f.name} folder contains stray folder \"{ff.name}\""))
+                # Compiled catalog (see i18n-compiler.py)
+                elif ff.name.endswith(".bin"):
+                    continue
                 # Known format
                 elif not ff.name.endswith(".json"):
                     warnings.append((2, f"{f.name} folder contains stray file \"{ff.name}\""))
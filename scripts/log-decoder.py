@@ -0,0 +1,208 @@
+"""
+Borealis, a Nintendo Switch UI Library
+Copyright (C) 2020  natinusala
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+"""
+# Run with Python 3
+
+# Decodes a binary log file (see brls::Logger::setBinaryLogFile) to text
+#
+# Binary log format (little endian):
+#   - header: magic "BRLB", version (u32)
+#   - then any number of entries, starting with their type:
+#       - 'F': format string - id (u32), level (u8), line (u32), file length (u16), file, format length (u32), format
+#       - 'L': log record - size (u32), format id (u32), time in ns (u64), args count (u8), args
+#       - 'D': dropped records - count (u64)
+#   - each arg is its type (u8, see brls::internal::LogArgType) followed by its value
+#
+# Format strings use the fmt syntax, which is close enough to Python's str.format()
+
+import argparse
+import struct
+import sys
+from datetime import datetime
+
+_MAGIC = b"BRLB"
+_VERSION = 1
+
+_LEVELS = ["ERROR", "WARNING", "INFO", "DEBUG"]
+
+
+class _Bool:
+    """Formats like fmt does ("true" / "false")"""
+
+    def __init__(self, value: bool):
+        self.value = value
+
+    def __format__(self, spec: str) -> str:
+        if spec and spec[-1] in "dxXob":
+            return format(int(self.value), spec)
+        return format("true" if self.value else "false", spec)
+
+
+class _Pointer:
+    """Formats like fmt does (0x...)"""
+
+    def __init__(self, value: int):
+        self.value = value
+
+    def __format__(self, spec: str) -> str:
+        return format(hex(self.value), spec)
+
+
+class _Reader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def eof(self) -> bool:
+        return self.pos >= len(self.data)
+
+    def read(self, fmt: str):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise EOFError()
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values[0] if len(values) == 1 else values
+
+    def read_bytes(self, size: int) -> bytes:
+        if self.pos + size > len(self.data):
+            raise EOFError()
+        value = self.data[self.pos : self.pos + size]
+        self.pos += size
+        return value
+
+
+def _read_arg(reader: _Reader):
+    arg_type = reader.read("<B")
+
+    if arg_type == 0:  # SIGNED
+        return reader.read("<q")
+    elif arg_type == 1:  # UNSIGNED
+        return reader.read("<Q")
+    elif arg_type == 2:  # FLOAT
+        return reader.read("<d")
+    elif arg_type == 3:  # BOOL
+        return _Bool(reader.read("<B") != 0)
+    elif arg_type == 4:  # CHAR
+        return chr(reader.read("<B"))
+    elif arg_type == 5:  # STRING
+        return reader.read_bytes(reader.read("<I")).decode("utf-8", errors="replace")
+    elif arg_type == 6:  # POINTER
+        return _Pointer(reader.read("<Q"))
+
+    raise ValueError(f"unknown argument type {arg_type}")
+
+
+def _decode(data: bytes, out, with_location: bool) -> int:
+    """Decodes the given binary log, returns the number of errors
+
+    Messages are sorted by time since every thread has its own buffer"""
+    reader = _Reader(data)
+
+    if reader.read_bytes(4) != _MAGIC:
+        raise ValueError("not a binary log file")
+
+    version = reader.read("<I")
+    if version != _VERSION:
+        raise ValueError(f"unsupported version {version}")
+
+    formats = {}
+    errors = 0
+    lines = []  # (time, line)
+    time = 0
+
+    while not reader.eof():
+        entry = reader.read_bytes(1)
+
+        if entry == b"F":
+            format_id, level, line = reader.read("<IBI")
+            file = reader.read_bytes(reader.read("<H")).decode("utf-8", errors="replace")
+            fmt = reader.read_bytes(reader.read("<I")).decode("utf-8", errors="replace")
+            formats[format_id] = (level, file, line, fmt)
+        elif entry == b"L":
+            size = reader.read("<I")
+            record = _Reader(reader.read_bytes(size))
+
+            format_id, time, args_count = record.read("<IQB")
+            args = [_read_arg(record) for _ in range(args_count)]
+
+            timestamp = datetime.fromtimestamp(time / 1e9).strftime("%Y-%m-%d %H:%M:%S.%f")[:-3]
+
+            if format_id not in formats:
+                lines.append((time, f"[{timestamp}] [?] <unknown format {format_id}> {args}"))
+                errors += 1
+                continue
+
+            level, file, line, fmt = formats[format_id]
+
+            try:
+                message = fmt.format(*args)
+            except (ValueError, IndexError, KeyError) as e:
+                message = f"<cannot format \"{fmt}\": {e}> {args}"
+                errors += 1
+
+            location = f" ({file}:{line})" if with_location else ""
+            level_name = _LEVELS[level] if level < len(_LEVELS) else str(level)
+            lines.append((time, f"[{timestamp}] [{level_name}]{location} {message}"))
+        elif entry == b"D":
+            lines.append((time, f"[WARNING] {reader.read('<Q')} log message(s) dropped: too many messages"))
+        else:
+            raise ValueError(f"unknown entry type {entry} at offset {reader.pos - 1}")
+
+    lines.sort(key=lambda line: line[0])
+
+    for _, line in lines:
+        out.write(f"{line}\n")
+
+    return errors
+
+
+if __name__ == "__main__":
+    # Arguments parsing
+    parser = argparse.ArgumentParser(description="Decode a binary log file to text")
+
+    parser.add_argument(
+        dest="path",
+        action="store",
+        help="The path to the binary log file",
+    )
+
+    parser.add_argument(
+        "-l",
+        "--location",
+        dest="location",
+        action="store_true",
+        help="Show the file and line of each message",
+    )
+
+    args = parser.parse_args()
+
+    with open(args.path, "rb") as f:
+        data = f.read()
+
+    try:
+        errors = _decode(data, sys.stdout, args.location)
+    except EOFError:
+        print("Binary log file is truncated", file=sys.stderr)
+        exit(1)
+    except ValueError as e:
+        print(f"Cannot decode binary log file: {e}", file=sys.stderr)
+        exit(1)
+
+    if errors:
+        print(f"{errors} message(s) could not be decoded", file=sys.stderr)
+        exit(1)